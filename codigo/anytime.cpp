@@ -0,0 +1,223 @@
+#include <csignal>
+#include <climits>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+#include "anytime.h"
+#include "timing.h"
+
+std::atomic<bool> should_stop(false);
+double stop_grace = 0.5;
+thread_local bool publishing_muted = false;
+static void (*anytime_print_result)(const EngineResult &result) = 0;
+static int wake_pipe[2] = {-1, -1};
+static std::atomic<bool> printing(false);
+
+/**
+ * Append-only trajectory of a slot. A full buffer is replaced by one twice as large holding the same
+ * events, the old one is never freed since the watcher may still be reading it
+ */
+typedef struct Events {
+    unsigned long capacity;
+    TrajectoryEvent *events;
+} Events;
+
+/**
+ * Incumbent published on a slot, the trajectory is the first events_num events of the slot buffer so
+ * the watcher can write --trajectory too. The scene order buffer starts with its capacity, a larger
+ * order gets a new buffer and the old one is never freed either
+ */
+typedef struct Published {
+    std::atomic<int *> scene_order;
+    unsigned long scenes_num;
+    unsigned long cost;
+    unsigned long bound;
+    unsigned long nodes;
+    unsigned long events_num;
+    double time_to_best;
+    unsigned long stamp;
+} Published;
+
+/**
+ * Incumbents published by one thread, published[(sequence / 2) % 2] holds the last one. The sequence
+ * is odd while the other one is written, so a reader knows its copy is consistent if the sequence did
+ * not move past the next publication. Only its thread writes a slot, so publishers never wait
+ */
+typedef struct Slot {
+    Published published[2];
+    std::atomic<unsigned long> sequence;
+    std::atomic<Events *> trajectory;
+    unsigned long events_appended;
+    Slot *next;
+} Slot;
+
+static int empty_order[1] = {0};
+static Events no_events = {0, NULL};
+static std::atomic<Slot *> slots(NULL);
+static thread_local Slot *own_slot = NULL;
+static std::atomic<unsigned long> publications(0);
+
+static void stop_execution(int signum) {
+    int saved_errno = errno;
+    should_stop = true;
+    char byte = 0;
+    if (write(wake_pipe[1], &byte, 1) < 0) {
+        // the watcher was already woken
+    }
+    errno = saved_errno;
+}
+
+static void read_slot(Slot &slot, EngineResult &incumbent, unsigned long &stamp) {
+    unsigned long start, end;
+    do {
+        start = slot.sequence.load(std::memory_order_acquire);
+        const Published &published = slot.published[(start / 2) % 2];
+        const int *scene_order = published.scene_order.load(std::memory_order_acquire);
+        unsigned long scenes_num = std::min(published.scenes_num, (unsigned long) scene_order[0]);
+        incumbent.scene_order.assign(scene_order + 1, scene_order + 1 + scenes_num);
+        incumbent.cost = published.cost;
+        incumbent.bound = published.bound;
+        incumbent.nodes = published.nodes;
+        incumbent.time_to_best = published.time_to_best;
+        stamp = published.stamp;
+        // the buffer loaded after events_num holds at least events_num events
+        unsigned long events_num = published.events_num;
+        const Events *events = slot.trajectory.load(std::memory_order_acquire);
+        events_num = std::min(events_num, events->capacity);
+        incumbent.trajectory.assign(events->events, events->events + events_num);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end = slot.sequence.load(std::memory_order_relaxed);
+    } while (end > (start | 1) + 1);
+}
+
+/**
+ * Reads the best incumbent of the slots, the last one published among the cheapest
+ */
+static void read_published(EngineResult &incumbent) {
+    unsigned long best_stamp = 0;
+    for (Slot *slot = slots.load(std::memory_order_acquire); slot != NULL; slot = slot->next) {
+        EngineResult published;
+        unsigned long stamp;
+        read_slot(*slot, published, stamp);
+        if (published.cost < incumbent.cost || (published.cost == incumbent.cost && stamp > best_stamp)) {
+            incumbent = published;
+            best_stamp = stamp;
+        }
+    }
+    if (incumbent.cost == ULONG_MAX) incumbent.scene_order.clear();
+}
+
+static void watch_stop() {
+    char byte;
+    while (read(wake_pipe[0], &byte, 1) < 0 && errno == EINTR) {}
+    double deadline = wall_seconds() + stop_grace;
+    while (!printing && wall_seconds() < deadline) {
+        usleep(1000);
+    }
+    if (printing.exchange(true)) return;
+    EngineResult incumbent;
+    reset_result(incumbent);
+    read_published(incumbent);
+    anytime_print_result(incumbent);
+    std::cout.flush();
+    fflush(stdout);
+    _exit(0);
+}
+
+void anytime_init(void (*print_result)(const EngineResult &result)) {
+    anytime_print_result = print_result;
+    if (pipe(wake_pipe) != 0) {
+        perror("pipe");
+        return;
+    }
+    std::thread(watch_stop).detach();
+    struct sigaction action;
+    action.sa_handler = stop_execution;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, NULL);
+}
+
+/**
+ * Slot of the calling thread, pushed on the list of slots the first time it publishes
+ */
+static Slot &thread_slot() {
+    if (own_slot == NULL) {
+        own_slot = new Slot;
+        for (int k = 0; k < 2; ++k) {
+            own_slot->published[k].scene_order.store(empty_order, std::memory_order_relaxed);
+            own_slot->published[k].scenes_num = 0;
+            own_slot->published[k].cost = ULONG_MAX;
+            own_slot->published[k].bound = 0;
+            own_slot->published[k].nodes = 0;
+            own_slot->published[k].events_num = 0;
+            own_slot->published[k].time_to_best = 0;
+            own_slot->published[k].stamp = 0;
+        }
+        own_slot->sequence.store(0, std::memory_order_relaxed);
+        own_slot->trajectory.store(&no_events, std::memory_order_relaxed);
+        own_slot->events_appended = 0;
+        own_slot->next = slots.load(std::memory_order_relaxed);
+        while (!slots.compare_exchange_weak(own_slot->next, own_slot, std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+    }
+    return *own_slot;
+}
+
+/**
+ * Appends the events of the trajectory not in the slot buffer yet. A shorter trajectory belongs to a
+ * new run and starts a new buffer
+ */
+static void append_events(Slot &slot, const std::vector<TrajectoryEvent> &trajectory) {
+    Events *events = slot.trajectory.load(std::memory_order_relaxed);
+    if (trajectory.size() < slot.events_appended) {
+        slot.events_appended = 0;
+        events = &no_events;
+    }
+    if (events->capacity < trajectory.size()) {
+        Events *grown = new Events;
+        grown->capacity = std::max(2 * events->capacity, (unsigned long) trajectory.size());
+        grown->events = new TrajectoryEvent[grown->capacity];
+        std::copy(events->events, events->events + slot.events_appended, grown->events);
+        events = grown;
+    }
+    std::copy(trajectory.begin() + slot.events_appended, trajectory.end(), events->events + slot.events_appended);
+    slot.trajectory.store(events, std::memory_order_release);
+    slot.events_appended = trajectory.size();
+}
+
+void publish_incumbent(const EngineResult &result) {
+    if (anytime_print_result == 0 || publishing_muted) return;
+    Slot &slot = thread_slot();
+    append_events(slot, result.trajectory);
+    unsigned long current = slot.sequence.load(std::memory_order_relaxed);
+    Published &published = slot.published[(current / 2 + 1) % 2];
+    slot.sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    int *scene_order = published.scene_order.load(std::memory_order_relaxed);
+    if ((unsigned long) scene_order[0] < result.scene_order.size()) {
+        scene_order = new int[result.scene_order.size() + 1];
+        scene_order[0] = (int) result.scene_order.size();
+        published.scene_order.store(scene_order, std::memory_order_release);
+    }
+    std::copy(result.scene_order.begin(), result.scene_order.end(), scene_order + 1);
+    published.scenes_num = result.scene_order.size();
+    published.cost = result.cost;
+    published.bound = result.bound;
+    published.nodes = result.nodes;
+    published.events_num = result.trajectory.size();
+    published.time_to_best = result.time_to_best;
+    published.stamp = publications.fetch_add(1, std::memory_order_relaxed) + 1;
+    slot.sequence.store(current + 2, std::memory_order_release);
+}
+
+void anytime_finish(const EngineResult &result) {
+    if (anytime_print_result == 0) return;
+    if (printing.exchange(true)) {
+        for (;;) pause();
+    }
+    anytime_print_result(result);
+}
@@ -0,0 +1,43 @@
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+#include <atomic>
+#include "engine.h"
+
+/**
+ * Anytime plumbing shared by the engines. The SIGINT handler only sets should_stop and wakes a
+ * watcher thread through a pipe. The watcher gives the engine stop_grace seconds to return and print
+ * its result with anytime_finish, past that it prints the last incumbent published with
+ * publish_incumbent, trajectory included, and exits. Without anytime_init (batch runs) publishing
+ * does nothing
+ */
+extern std::atomic<bool> should_stop;
+extern double stop_grace;
+
+/**
+ * Set on the threads solving a part of the instance, whose incumbents are not published
+ */
+extern thread_local bool publishing_muted;
+
+/**
+ * Registers the SIGINT handler and starts the watcher, print_result writes a result in the engine
+ * output format
+ */
+void anytime_init(void (*print_result)(const EngineResult &result));
+
+/**
+ * Publishes the incumbent of result and its trajectory for the watcher without locking it out. Every
+ * thread publishes on its own slot, so no publisher waits for another: the incumbent is copied to the
+ * half of the slot the watcher is not reading and a sequence number swaps the halves, the trajectory
+ * only gets the events recorded since the last publication. The watcher takes the cheapest incumbent
+ * of the slots
+ */
+void publish_incumbent(const EngineResult &result);
+
+/**
+ * Prints the final result of the engine unless the watcher is already printing the published one,
+ * in which case it waits for the watcher to exit the process
+ */
+void anytime_finish(const EngineResult &result);
+
+#endif
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <sys/stat.h>
+#include "engine.h"
+#include "instance.h"
+#include "timing.h"
+
+using namespace std;
+
+typedef bool (*EngineRun)(const Instance &instance, const vector<string> &args, double deadline,
+                          EngineResult &result);
+
+/**
+ * Instance of the batch and its run, an instance with the same hash as an earlier one (the .txt and
+ * .dat of the same instance) reuses its result instead of being solved again
+ */
+typedef struct BatchEntry {
+    string name;
+    Instance instance;
+    bool loaded;
+    int same_as;
+    EngineResult result;
+    double time;
+    long peak_rss;
+} BatchEntry;
+
+string engine_name;
+EngineRun engine_run;
+vector<string> engine_args;
+double time_limit = 0;
+unsigned int jobs = 1;
+vector<BatchEntry> entries;
+atomic<size_t> next_entry(0);
+
+/**
+ * Peak resident set size of the process in KB, -1 if /proc is not available
+ */
+long peak_rss() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return atol(line.c_str() + 6);
+    }
+    return -1;
+}
+
+/**
+ * Resets the peak resident set size to the current one (Linux 4.0+), used when runs are sequential
+ */
+void reset_peak_rss() {
+    ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+}
+
+bool load_entries(const string &directory) {
+    struct stat info;
+    if (stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) return false;
+    vector<string> paths = list_instances(directory);
+    entries.resize(paths.size());
+    for (int k = 0; k < paths.size(); ++k) {
+        BatchEntry &entry = entries[k];
+        entry.name = paths[k].substr(directory.size() + 1);
+        entry.loaded = load_instance(paths[k].c_str(), entry.instance);
+        entry.same_as = -1;
+        entry.time = 0;
+        entry.peak_rss = -1;
+        reset_result(entry.result);
+        if (!entry.loaded) {
+            cerr << "Não foi possível abrir o arquivo de entrada " << entry.name << endl;
+            continue;
+        }
+        for (int other = 0; other < k && entry.same_as == -1; ++other) {
+            if (entries[other].loaded && entries[other].same_as == -1 &&
+                entries[other].instance.hash == entry.instance.hash) {
+                entry.same_as = other;
+            }
+        }
+    }
+    return true;
+}
+
+void run_entries() {
+    size_t k;
+    while ((k = next_entry++) < entries.size()) {
+        BatchEntry &entry = entries[k];
+        if (!entry.loaded || entry.same_as != -1) continue;
+        if (jobs == 1) reset_peak_rss();
+        double start = wall_seconds();
+        entry.loaded = engine_run(entry.instance, engine_args, time_limit > 0 ? start + time_limit : 0, entry.result);
+        entry.time = wall_seconds() - start;
+        entry.peak_rss = peak_rss();
+        fprintf(stderr, "%s %lu %.2fs\n", entry.name.c_str(), entry.result.cost, entry.time);
+    }
+}
+
+string scene_order_text(const EngineResult &result) {
+    string text;
+    char scene[16];
+    for (int l = 0; l < result.scene_order.size(); ++l) {
+        snprintf(scene, sizeof(scene), l ? " %d" : "%d", result.scene_order[l]);
+        text += scene;
+    }
+    return text;
+}
+
+string hash_text(const Instance &instance) {
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", instance.hash);
+    return hash;
+}
+
+void write_csv(ostream &out) {
+    out << "Instancia;Hash;Solucao;Custo;Lim. Inf.;Nos;Tempo;Tempo melhor;RSS pico (KB);Otimo" << endl;
+    for (int k = 0; k < entries.size(); ++k) {
+        const BatchEntry &entry = entries[k];
+        if (!entry.loaded) {
+            out << entry.name << ";erro;erro;erro;erro;erro;erro;erro;erro;erro" << endl;
+            continue;
+        }
+        const EngineResult &result = entry.result;
+        out << entry.name << ";" << hash_text(entry.instance) << ";" << scene_order_text(result) << ";";
+        if (result.cost == ULONG_MAX) {
+            out << "-";
+        } else {
+            out << result.cost;
+        }
+        out << ";" << result.bound << ";" << result.nodes << ";" << entry.time << ";" << result.time_to_best << ";"
+            << entry.peak_rss << ";" << (result.optimal ? 1 : 0) << endl;
+    }
+}
+
+void write_json(ostream &out) {
+    out << "[" << endl;
+    for (int k = 0; k < entries.size(); ++k) {
+        const BatchEntry &entry = entries[k];
+        const EngineResult &result = entry.result;
+        out << "  {\"instance\": \"" << entry.name << "\", \"engine\": \"" << engine_name << "\", \"loaded\": "
+            << (entry.loaded ? "true" : "false");
+        if (entry.loaded) {
+            out << ", \"hash\": \"" << hash_text(entry.instance) << "\", \"scenes\": " << entry.instance.days_num
+                << ", \"actors\": " << entry.instance.actors_num << ", \"solution\": [";
+            for (int l = 0; l < result.scene_order.size(); ++l) {
+                out << (l ? ", " : "") << result.scene_order[l];
+            }
+            out << "], \"cost\": ";
+            if (result.cost == ULONG_MAX) {
+                out << "null";
+            } else {
+                out << result.cost;
+            }
+            out << ", \"bound\": " << result.bound << ", \"nodes\": " << result.nodes << ", \"optimal\": "
+                << (result.optimal ? "true" : "false") << ", \"time\": " << entry.time << ", \"time_to_best\": "
+                << result.time_to_best << ", \"peak_rss_kb\": " << entry.peak_rss;
+        }
+        out << "}" << (k + 1 < entries.size() ? "," : "") << endl;
+    }
+    out << "]" << endl;
+}
+
+/**
+ * Main function, solves every instance of a directory in this process with a pool of threads
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] the engine (bnb, heur or dp), argv[2] the directory of instances (.txt, .dat or .bin),
+ *             then --jobs n, --time seconds per instance (180 for bnb and dp, 30 for heur), --csv file,
+ *             --json file, --trajectory file, any other option is given to the engine
+ * @return 0 in case of success
+ */
+int main(int argc, const char *argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <bnb | heur | dp> <dir-instancias> [--jobs n] [--time s] [--csv arquivo]"
+             << " [--json arquivo] [--trajectory arquivo] [opcoes do algoritmo]" << endl;
+        exit(1);
+    }
+    engine_name = argv[1];
+    if (engine_name == "bnb") {
+        engine_run = run_bnb;
+        time_limit = 180;
+    } else if (engine_name == "heur") {
+        engine_run = run_heur;
+        time_limit = 30;
+    } else if (engine_name == "dp") {
+        engine_run = run_dp;
+        time_limit = 180;
+    } else {
+        cerr << "O algoritmo especificado deve ser 'bnb', 'heur' ou 'dp'" << endl;
+        exit(1);
+    }
+    const char *csv_path = NULL, *json_path = NULL, *trajectory_path = NULL;
+    for (int i = 3; i < argc; ++i) {
+        if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = (unsigned int) max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            time_limit = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--trajectory") == 0 && i + 1 < argc) {
+            trajectory_path = argv[++i];
+        } else {
+            engine_args.push_back(argv[i]);
+        }
+    }
+    if (!load_entries(argv[2])) {
+        cerr << "Diretorio de instancias nao encontrado" << endl;
+        exit(1);
+    }
+
+    vector<thread> workers;
+    for (unsigned int w = 1; w < jobs; ++w) {
+        workers.push_back(thread(run_entries));
+    }
+    run_entries();
+    for (int w = 0; w < workers.size(); ++w) {
+        workers[w].join();
+    }
+    for (int k = 0; k < entries.size(); ++k) {
+        if (entries[k].same_as != -1) {
+            const BatchEntry &source = entries[entries[k].same_as];
+            entries[k].loaded = source.loaded;
+            entries[k].result = source.result;
+            entries[k].time = source.time;
+            entries[k].peak_rss = source.peak_rss;
+        }
+    }
+
+    if (csv_path != NULL) {
+        ofstream csv(csv_path);
+        write_csv(csv);
+    }
+    if (json_path != NULL) {
+        ofstream json(json_path);
+        write_json(json);
+    }
+    if (trajectory_path != NULL) {
+        for (int k = 0; k < entries.size(); ++k) {
+            if (entries[k].loaded &&
+                !write_trajectory(trajectory_path, entries[k].name, engine_name, entries[k].result)) {
+                cerr << "Não foi possível escrever a trajetória " << trajectory_path << endl;
+                break;
+            }
+        }
+    }
+    if (csv_path == NULL && json_path == NULL) {
+        write_csv(cout);
+    }
+    return 0;
+}
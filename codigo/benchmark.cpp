@@ -0,0 +1,405 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include "bnb.h"
+#include "engine.h"
+#include "heur.h"
+#include "instance.h"
+#include "schedule.h"
+#include "timing.h"
+
+using namespace std;
+
+/**
+ * A measure of a benchmark on an instance. Benchmarks whose name ends with _per_s are better when
+ * higher, every other one when lower
+ */
+typedef struct Sample {
+    string benchmark;
+    string instance;
+    int sample;
+    double value;
+} Sample;
+
+/**
+ * Samples of a benchmark on an instance of the baseline and of the current run
+ */
+typedef struct Comparison {
+    vector<double> baseline;
+    vector<double> current;
+} Comparison;
+
+int sample_count = 10;
+double sample_time = 0.1;
+int repeat = 3;
+double time_limit = 0;
+double alpha = 0.01;
+double tolerance = 0.1;
+vector<Sample> samples;
+
+void add_sample(const string &benchmark, const string &instance, int sample, double value) {
+    Sample measure;
+    measure.benchmark = benchmark;
+    measure.instance = instance;
+    measure.sample = sample;
+    measure.value = value;
+    samples.push_back(measure);
+}
+
+/**
+ * Runs operation(k) for k = 0, 1, ... until sample_time has passed, sample_count times
+ */
+template<typename Operation>
+void measure(const string &benchmark, const string &instance, Operation operation) {
+    unsigned long k = 0;
+    for (int sample = 0; sample < sample_count; ++sample) {
+        unsigned long operations = 0;
+        double start = wall_seconds(), elapsed;
+        do {
+            for (int batch = 0; batch < 16; ++batch, ++operations) {
+                operation(k++);
+            }
+            elapsed = wall_seconds() - start;
+        } while (elapsed < sample_time);
+        add_sample(benchmark, instance, sample, elapsed * 1e9 / operations);
+    }
+}
+
+/**
+ * Nodes of a random dive from the root of the branch and bound down to half of the scenes
+ */
+vector<bnb::Solution> dive_nodes(unsigned long days_num) {
+    vector<bnb::Solution> nodes(1);
+    bnb::init_root(nodes[0]);
+    for (int depth = 0; depth < days_num / 2; ++depth) {
+        const bnb::Solution &parent = nodes.back();
+        bool insert_start = parent.end_scenes.size() >= parent.start_scenes.size();
+        bnb::Solution child;
+        bnb::expand_child(parent, rand() % parent.avaible_scenes.size(), insert_start, child);
+        nodes.push_back(child);
+    }
+    return nodes;
+}
+
+/**
+ * Microbenchmarks, in ns per call: the reference cost, the heur chromosome evaluation from the start
+ * and from a random position and the bnb child expansion and bound estimation
+ */
+void run_micro(const string &path) {
+    Instance instance;
+    if (!load_instance(path.c_str(), instance)) {
+        cerr << "Não foi possível abrir o arquivo de entrada " << path << endl;
+        return;
+    }
+    string name = path.substr(path.rfind('/') + 1);
+    unsigned long days_num = instance.days_num;
+    srand(1);
+    vector<vector<int> > orders(64, vector<int>(days_num));
+    for (int k = 0; k < orders.size(); ++k) {
+        for (int j = 0; j < days_num; ++j) {
+            orders[k][j] = j;
+        }
+        random_shuffle(orders[k].begin(), orders[k].end());
+    }
+    volatile unsigned long checksum = 0;
+    measure("schedule_cost_ns", name, [&](unsigned long k) {
+        checksum += schedule_cost(instance, orders[k % orders.size()]);
+    });
+
+    heur::init_data(instance);
+    vector<heur::Solution> chromosomes(orders.size());
+    vector<int> positions(orders.size());
+    for (int k = 0; k < orders.size(); ++k) {
+        chromosomes[k].scenes = orders[k];
+        heur::evaluate(chromosomes[k], 0, ULONG_MAX, true);
+        positions[k] = rand() % days_num;
+    }
+    measure("evaluate_ns", name, [&](unsigned long k) {
+        heur::evaluate(chromosomes[k % chromosomes.size()], 0);
+    });
+    measure("evaluate_partial_ns", name, [&](unsigned long k) {
+        heur::evaluate(chromosomes[k % chromosomes.size()], positions[k % positions.size()], ULONG_MAX, true);
+    });
+
+    bnb::init_data(instance);
+    vector<bnb::Solution> nodes = dive_nodes(days_num);
+    vector<bnb::Solution> children(nodes.size());
+    for (int k = 0; k < nodes.size(); ++k) {
+        bool insert_start = nodes[k].end_scenes.size() >= nodes[k].start_scenes.size();
+        if (!nodes[k].avaible_scenes.empty()) bnb::expand_child(nodes[k], 0, insert_start, children[k]);
+    }
+    // the last node of the dive may have no scenes left
+    unsigned long expandable = nodes.size() - (nodes.back().avaible_scenes.empty() ? 1 : 0);
+    measure("expand_child_ns", name, [&](unsigned long k) {
+        const bnb::Solution &parent = nodes[k % expandable];
+        bool insert_start = parent.end_scenes.size() >= parent.start_scenes.size();
+        bnb::Solution child;
+        bnb::expand_child(parent, (int) (k % parent.avaible_scenes.size()), insert_start, child);
+        checksum += child.cost;
+    });
+    measure("bound_ns", name, [&](unsigned long k) {
+        checksum += bnb::astar_estimate(children[k % expandable]);
+    });
+}
+
+/**
+ * Macrobenchmarks: solves the instance repeat times within time_limit, recording the engine speed and
+ * the time to optimal (bnb and dp, when they prove optimality) or the time to best and cost (heur)
+ */
+void run_macro(const string &engine, const string &path) {
+    Instance instance;
+    if (!load_instance(path.c_str(), instance)) {
+        cerr << "Não foi possível abrir o arquivo de entrada " << path << endl;
+        return;
+    }
+    string name = path.substr(path.rfind('/') + 1);
+    for (int sample = 0; sample < repeat; ++sample) {
+        EngineResult result;
+        double start = wall_seconds();
+        if (engine == "bnb") {
+            run_bnb(instance, vector<string>(), start + time_limit, result);
+        } else if (engine == "dp") {
+            run_dp(instance, vector<string>(), start + time_limit, result);
+        } else {
+            run_heur(instance, vector<string>(), start + time_limit, result);
+        }
+        double elapsed = wall_seconds() - start;
+        add_sample(engine + "_nodes_per_s", name, sample, result.nodes / elapsed);
+        if (engine != "heur" && result.optimal) {
+            add_sample(engine + "_time_to_optimal_s", name, sample, elapsed);
+        } else if (engine == "heur") {
+            add_sample("heur_time_to_best_s", name, sample, result.time_to_best);
+            add_sample("heur_cost", name, sample, (double) result.cost);
+        }
+        cerr << engine << " " << name << " " << result.cost << " " << elapsed << "s" << endl;
+    }
+}
+
+void write_samples(ostream &out, bool header) {
+    if (header) out << "Benchmark;Instancia;Amostra;Valor" << endl;
+    for (int k = 0; k < samples.size(); ++k) {
+        out << samples[k].benchmark << ";" << samples[k].instance << ";" << samples[k].sample << ";"
+            << samples[k].value << endl;
+    }
+}
+
+/**
+ * Reads the samples of a benchmark output into comparisons, on the baseline or current side
+ */
+bool read_samples(const char *path, map<pair<string, string>, Comparison> &comparisons, bool baseline) {
+    ifstream file(path);
+    if (!file) return false;
+    string line;
+    getline(file, line);
+    while (getline(file, line)) {
+        if (line.empty() || line.compare(0, 9, "Benchmark") == 0) continue;
+        stringstream fields(line);
+        string benchmark, instance, sample, value;
+        getline(fields, benchmark, ';');
+        getline(fields, instance, ';');
+        getline(fields, sample, ';');
+        getline(fields, value, ';');
+        Comparison &comparison = comparisons[make_pair(benchmark, instance)];
+        (baseline ? comparison.baseline : comparison.current).push_back(atof(value.c_str()));
+    }
+    return true;
+}
+
+/**
+ * Continued fraction of the regularized incomplete beta function (Numerical Recipes betacf)
+ */
+double beta_fraction(double a, double b, double x) {
+    double c = 1, d = 1 - (a + b) * x / (a + 1);
+    if (fabs(d) < 1e-300) d = 1e-300;
+    d = 1 / d;
+    double fraction = d;
+    for (int m = 1; m <= 200; ++m) {
+        double numerator = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+        d = 1 + numerator * d;
+        c = 1 + numerator / c;
+        d = 1 / (fabs(d) < 1e-300 ? 1e-300 : d);
+        c = fabs(c) < 1e-300 ? 1e-300 : c;
+        fraction *= d * c;
+        numerator = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+        d = 1 + numerator * d;
+        c = 1 + numerator / c;
+        d = 1 / (fabs(d) < 1e-300 ? 1e-300 : d);
+        c = fabs(c) < 1e-300 ? 1e-300 : c;
+        double delta = d * c;
+        fraction *= delta;
+        if (fabs(delta - 1) < 1e-12) break;
+    }
+    return fraction;
+}
+
+double incomplete_beta(double a, double b, double x) {
+    if (x <= 0) return 0;
+    if (x >= 1) return 1;
+    double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1 - x));
+    if (x < (a + 1) / (a + b + 2)) return front * beta_fraction(a, b, x) / a;
+    return 1 - front * beta_fraction(b, a, 1 - x) / b;
+}
+
+void mean_variance(const vector<double> &values, double &mean, double &variance) {
+    mean = variance = 0;
+    for (int k = 0; k < values.size(); ++k) mean += values[k];
+    mean /= values.size();
+    for (int k = 0; k < values.size(); ++k) variance += (values[k] - mean) * (values[k] - mean);
+    variance = values.size() > 1 ? variance / (values.size() - 1) : 0;
+}
+
+/**
+ * Two-sided p-value of Welch's t-test, samples without variance differ with p 0 unless their means are
+ * equal
+ */
+double welch_p_value(const vector<double> &first, const vector<double> &second) {
+    double first_mean, first_variance, second_mean, second_variance;
+    mean_variance(first, first_mean, first_variance);
+    mean_variance(second, second_mean, second_variance);
+    double first_error = first_variance / first.size(), second_error = second_variance / second.size();
+    if (first_error + second_error == 0) return first_mean == second_mean ? 1 : 0;
+    double t = (first_mean - second_mean) / sqrt(first_error + second_error);
+    double freedom = (first_error + second_error) * (first_error + second_error) /
+                     (first_error * first_error / max(1.0, first.size() - 1.0) +
+                      second_error * second_error / max(1.0, second.size() - 1.0));
+    return incomplete_beta(freedom / 2, 0.5, freedom / (freedom + t * t));
+}
+
+bool higher_is_better(const string &benchmark) {
+    return benchmark.size() > 6 && benchmark.compare(benchmark.size() - 6, 6, "_per_s") == 0;
+}
+
+/**
+ * Compares the current samples with the baseline ones, a regression is a change to the worse side
+ * larger than tolerance with Welch p-value below alpha
+ * @return the number of regressions
+ */
+int compare(const char *baseline_path, const char *current_path) {
+    map<pair<string, string>, Comparison> comparisons;
+    if (!read_samples(baseline_path, comparisons, true) || !read_samples(current_path, comparisons, false)) {
+        cerr << "Não foi possível ler os resultados " << baseline_path << " e " << current_path << endl;
+        exit(1);
+    }
+    int regressions = 0;
+    cout << "Benchmark;Instancia;Base;Atual;Variacao;p;Resultado" << endl;
+    for (map<pair<string, string>, Comparison>::iterator it = comparisons.begin(); it != comparisons.end(); ++it) {
+        const Comparison &comparison = it->second;
+        if (comparison.baseline.empty() || comparison.current.empty()) continue;
+        double baseline_mean, current_mean, variance;
+        mean_variance(comparison.baseline, baseline_mean, variance);
+        mean_variance(comparison.current, current_mean, variance);
+        double change = baseline_mean != 0 ? (current_mean - baseline_mean) / fabs(baseline_mean) : 0;
+        double p_value = welch_p_value(comparison.baseline, comparison.current);
+        bool worse = higher_is_better(it->first.first) ? change < -tolerance : change > tolerance;
+        bool better = higher_is_better(it->first.first) ? change > tolerance : change < -tolerance;
+        const char *verdict = "igual";
+        if (p_value < alpha && worse) {
+            verdict = "REGRESSAO";
+            regressions++;
+        } else if (p_value < alpha && better) {
+            verdict = "melhora";
+        }
+        char line[128];
+        snprintf(line, sizeof(line), "%g;%g;%+.1f%%;%.3g;%s", baseline_mean, current_mean, change * 100, p_value,
+                 verdict);
+        cout << it->first.first << ";" << it->first.second << ";" << line << endl;
+    }
+    return regressions;
+}
+
+/**
+ * Main function, benchmark suite
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] the mode:
+ *             micro <instances or directories...> [--samples n] [--sample-time s]
+ *             macro <bnb | heur | dp> <instances or directories...> [--time s] [--repeat n]
+ *             compare <baseline.csv> <current.csv> [--alpha a] [--tolerance fraction]
+ *             micro and macro take --output file to append the samples to it instead of writing them on cout
+ * @return 0 in case of success, 2 if compare found regressions
+ */
+int main(int argc, const char *argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " micro <instancias...> | macro <bnb | heur | dp> <instancias...> |"
+             << " compare <base.csv> <atual.csv>" << endl;
+        exit(1);
+    }
+    string mode = argv[1];
+    const char *output_path = NULL;
+    vector<string> paths;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sample_count = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--sample-time") == 0 && i + 1 < argc) {
+            sample_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            time_limit = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            alpha = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (mode == "compare") {
+        if (paths.size() != 2) {
+            cerr << "Uso: " << argv[0] << " compare <base.csv> <atual.csv>" << endl;
+            exit(1);
+        }
+        return compare(paths[0].c_str(), paths[1].c_str()) > 0 ? 2 : 0;
+    }
+
+    string engine;
+    if (mode == "macro") {
+        engine = paths.empty() ? "" : paths[0];
+        if (engine != "bnb" && engine != "heur" && engine != "dp") {
+            cerr << "O algoritmo especificado deve ser 'bnb', 'heur' ou 'dp'" << endl;
+            exit(1);
+        }
+        paths.erase(paths.begin());
+        if (time_limit == 0) time_limit = engine == "heur" ? 2 : 10;
+    } else if (mode != "micro") {
+        cerr << "Modo desconhecido " << mode << endl;
+        exit(1);
+    }
+    // the .txt and .dat of an instance are measured once
+    vector<unsigned long long> hashes;
+    for (int p = 0; p < paths.size(); ++p) {
+        vector<string> instances = list_instances(paths[p]);
+        for (int k = 0; k < instances.size(); ++k) {
+            Instance instance;
+            if (load_instance(instances[k].c_str(), instance)) {
+                if (find(hashes.begin(), hashes.end(), instance.hash) != hashes.end()) continue;
+                hashes.push_back(instance.hash);
+            }
+            if (mode == "micro") {
+                run_micro(instances[k]);
+            } else {
+                run_macro(engine, instances[k]);
+            }
+        }
+    }
+
+    if (output_path != NULL) {
+        ifstream existing(output_path);
+        bool header = !existing || existing.peek() == EOF;
+        existing.close();
+        ofstream output(output_path, ios::app);
+        write_samples(output, header);
+    } else {
+        write_samples(cout, true);
+    }
+    return 0;
+}
@@ -1,395 +1,1050 @@
 #include <iostream>
 #include <cstdlib>
 #include <vector>
-#include <csignal>
 #include <queue>
 #include <fstream>
 #include <climits>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <string>
+#include "anytime.h"
+#include "bnb.h"
+#include "engine.h"
+#include "incumbent_channel.h"
+#include "instance.h"
+#include "schedule.h"
+#include "timing.h"
 
 using namespace std;
 
+namespace bnb {
+
 /**
- * Actor data definition
+ * Sets min/max initial cost and solves the problem, the state is per thread so runs can be parallel
  */
-typedef struct Actor {
-    int start;
-    int end;
-    int filmed_scenes;
-    unsigned long cost;
-    bool complete;
-    int id;
-} Actor;
+thread_local unsigned long max_cost;
+thread_local unsigned long days_num_lkup;
+thread_local unsigned long actors_num_lkup;
+thread_local const Instance *instance_lkup;
+thread_local vector<ActorLkup> actors_lkup;
+thread_local bool solved;
+thread_local bool stopped;
+thread_local double deadline;
+thread_local double start_time;
+thread_local EngineResult *result;
 
 /**
- * ActorLkup data definition
+ * Root LP written by pli-solver --root: bound, LP day of each scene and reduced cost of each scene/day
  */
-typedef struct ActorLkup {
-    int total_scenes;
-    unsigned long cost;
-} ActorLkup;
+thread_local bool root_loaded;
+thread_local double root_bound;
+thread_local unsigned long min_cost;
+thread_local vector<double> root_positions;
+thread_local vector<vector<double> > root_reduced_costs;
 
 /**
- * OrderedScene by cost desc
+ * Tolerance of a root LP bound plus terms reduced costs: the feasibility tolerance of the LP and the
+ * error of each term summed, never below root_min_tolerance
  */
-typedef struct OrderedScene {
-    int scene;
-    unsigned long cost;
+const double root_lp_tolerance = 1e-7;
+const double root_term_tolerance = 1e-9;
+const double root_min_tolerance = 1e-4;
 
-    bool operator<(const OrderedScene &compareTo) const {
-        return cost < compareTo.cost;
+double root_tolerance(size_t terms) {
+    return max(root_min_tolerance, root_lp_tolerance + root_term_tolerance * terms);
+}
+
+/**
+ * A* mode (--astar): the least cost found for each pair of start and end scene sets, every order of
+ * the same sets has the same completions so only the cheapest one is expanded
+ */
+typedef struct MasksHash {
+    size_t operator()(const pair<unsigned long long, unsigned long long> &masks) const {
+        return (size_t) (masks.first * 0x9E3779B97F4A7C15ULL ^ masks.second);
     }
-} OrderedScene;
+} MasksHash;
+
+typedef unordered_map<pair<unsigned long long, unsigned long long>, unsigned long, MasksHash> ClosedTable;
+
+thread_local bool astar_enabled;
+thread_local size_t astar_max_nodes;
+thread_local ClosedTable closed;
+
 /**
- * A solution
+ * Beam mode (--beam): width of the first pass, doubled on every pass
  */
-typedef struct Solution {
-    vector<int> start_scenes;
-    vector<int> end_scenes;
-    vector<int> avaible_scenes;
+thread_local bool beam_enabled;
+thread_local size_t beam_width;
+const size_t beam_max_width = 1 << 16;
+
+/**
+ * Dives of the depth-first search (disabled with --no-dive): nodes until the next dive, halved when a
+ * dive improves the incumbent and doubled when it does not
+ */
+thread_local bool dive_enabled;
+thread_local unsigned long dive_interval;
+thread_local unsigned long next_dive;
+const unsigned long dive_min_interval = 64;
+const unsigned long dive_max_interval = 1 << 20;
+
+/**
+ * Dominance rules of the depth-first search (disabled with --no-dominance)
+ */
+thread_local bool dominance_enabled;
+
+/**
+ * Leaf DP (--leaf-dp k, 0 disables it): a node with at most k available scenes is finished by a DP over
+ * the subsets of its middle. The best middle of each pair of start and end scene sets is kept, sibling
+ * subtrees reach the same sets in other orders. A DP pruned by the incumbent keeps only a lower bound,
+ * the order is then empty. The table is emptied when it is full
+ */
+typedef struct LeafEntry {
     unsigned long cost;
-    priority_queue<Solution> solutions;
-    vector<Actor> actors;
-    unsigned long possible_cost;
+    vector<int> order;
+} LeafEntry;
 
-    bool operator<(const Solution &compareTo) const {
-        return possible_cost + cost > compareTo.possible_cost + compareTo.cost;
-    };
+typedef unordered_map<pair<unsigned long long, unsigned long long>, LeafEntry, MasksHash> LeafTable;
 
-} Solution;
+thread_local unsigned long leaf_scenes;
+thread_local LeafTable leaves;
+const size_t leaf_max_entries = 1 << 16;
 
 /**
- * Sets min/max initial cost and solves the problem
+ * Threads evaluating the children of a beam depth or solving the components of the instance (--threads)
  */
-unsigned long node_count = 0;
-unsigned long max_cost = ULONG_MAX;
-Solution best_solution;
-unsigned long days_num_lkup;
-unsigned long actors_num_lkup;
-vector<vector<int> > actors_scenes_lkup;
-vector<ActorLkup> actors_lkup;
-bool best_solution_updating = false;
-bool should_stop = false;
-bool solved = false;
-
-void init_data(unsigned long days_num, unsigned long actors_num, vector<vector<int> > actors_scenes,
-               vector<unsigned long> actors_cost) {
-    days_num_lkup = days_num;
-    actors_num_lkup = actors_num;
-    actors_scenes_lkup = actors_scenes;
-    for (int i = 0; i < actors_num; ++i) {
-        ActorLkup actor_lkup;
-        actor_lkup.cost = actors_cost[i];
-        actor_lkup.total_scenes = 0;
-        for (int j = 0; j < days_num; ++j) {
-            if (actors_scenes_lkup[i][j]) actor_lkup.total_scenes++;
-        }
-        actors_lkup.push_back(actor_lkup);
-    }
+thread_local unsigned int threads_num;
+
+/**
+ * Incumbent shared with the other engines of a portfolio run, NULL when running alone
+ */
+thread_local IncumbentChannel *channel;
+
+/**
+ * Cost used to prune, the own incumbent or a better one found by another engine
+ */
+unsigned long prune_cost() {
+    if (channel == NULL) return max_cost;
+    return min(max_cost, channel_cost(channel));
 }
 
-void print_formatted_result() {
-    for (int l = 0; l < best_solution.start_scenes.size(); ++l) {
-        cout << best_solution.start_scenes[l] << " ";
+bool read_root(const char *path, unsigned long days_num) {
+    ifstream root_file(path);
+    unsigned long root_days;
+    if (!(root_file >> root_bound >> root_days) || root_days != days_num) return false;
+    root_positions.resize(days_num);
+    for (int j = 0; j < days_num; ++j) {
+        root_file >> root_positions[j];
     }
-    for (int l = 0; l < best_solution.end_scenes.size(); ++l) {
-        cout << best_solution.end_scenes[l] << " ";
+    root_reduced_costs.assign(days_num, vector<double>(days_num));
+    for (int j = 0; j < days_num; ++j) {
+        for (int d = 0; d < days_num; ++d) {
+            root_file >> root_reduced_costs[j][d];
+        }
     }
-    cout << endl << max_cost << endl;
-    // if the problem wasn't solved the source is already active with minCost = 0, else the best solution is already found
-    cout << (solved ? max_cost : 0) << endl;
-    cout << node_count << endl;
+    if (!root_file) return false;
+    min_cost = (unsigned long) ceil(root_bound - root_tolerance(0));
+    root_loaded = true;
+    return true;
 }
 
-void solve(Solution solution) {
-    node_count++;
-    // verifies if it is a complete, it will only enter the function if solution.cost < max_cost
-    if (solution.avaible_scenes.size() == 0) {
-        best_solution_updating  = true;
-        max_cost = solution.cost;
-        best_solution = solution;
-        best_solution_updating = false;
-        if (should_stop) {
-            print_formatted_result();
-            exit(0);
-        }
-        return;
+void init_data(const Instance &instance) {
+    instance_lkup = &instance;
+    days_num_lkup = instance.days_num;
+    actors_num_lkup = instance.actors_num;
+    actors_lkup = build_actors_lkup(instance);
+}
+
+bool expand_child(const Solution &solution, int i, bool insert_start, Solution &child) {
+    child.reduced_cost = solution.reduced_cost;
+    child.lp_distance = 0;
+    if (root_loaded) {
+        // every placement fixes a scene/day variable, the LP bound plus their reduced costs is valid
+        int scene = solution.avaible_scenes[i];
+        int day = insert_start ? (int) solution.start_scenes.size() :
+                  (int) (days_num_lkup - solution.end_scenes.size()) - 1;
+        child.reduced_cost += root_reduced_costs[scene][day];
+        size_t terms = solution.start_scenes.size() + solution.end_scenes.size() + 1;
+        if (ceil(root_bound + child.reduced_cost - root_tolerance(terms)) >= prune_cost()) return false;
+        child.lp_distance = fabs(root_positions[scene] - (day + 1));
     }
+    if (insert_start) {
+        // create child and calculate its cost
+        child.end_scenes = solution.end_scenes;
 
-    // verifies if should insert start or end
-    bool insert_start = solution.end_scenes.size() >= solution.start_scenes.size();
-    // inserting on the end of the schedule
-    for (int i = 0; i < solution.avaible_scenes.size(); ++i) {
-        Solution child;
-        if (insert_start) {
-            // create child and calculate its cost
-            child.end_scenes = solution.end_scenes;
+        child.start_scenes = solution.start_scenes;
+        child.start_scenes.push_back(solution.avaible_scenes[i]);
 
-            child.start_scenes = solution.start_scenes;
-            child.start_scenes.push_back(solution.avaible_scenes[i]);
+        child.avaible_scenes = solution.avaible_scenes;
+        child.avaible_scenes.erase(child.avaible_scenes.begin() + i);
 
-            child.avaible_scenes = solution.avaible_scenes;
-            child.avaible_scenes.erase(child.avaible_scenes.begin() + i);
+        child.actors = solution.actors;
+        child.cost = 0;
+        child.possible_cost = 0;
+    } else {
+        child.start_scenes = solution.start_scenes;
 
-            child.actors = solution.actors;
-            child.cost = 0;
-            child.possible_cost = 0;
-        } else {
-            child.start_scenes = solution.start_scenes;
+        child.end_scenes.push_back(solution.avaible_scenes[i]);
+        child.end_scenes.insert(child.end_scenes.end(), solution.end_scenes.begin(), solution.end_scenes.end());
 
-            child.end_scenes.push_back(solution.avaible_scenes[i]);
-            child.end_scenes.insert(child.end_scenes.end(), solution.end_scenes.begin(), solution.end_scenes.end());
+        child.avaible_scenes = solution.avaible_scenes;
+        child.avaible_scenes.erase(child.avaible_scenes.begin() + i);
 
-            child.avaible_scenes = solution.avaible_scenes;
-            child.avaible_scenes.erase(child.avaible_scenes.begin() + i);
-
-            child.actors = solution.actors;
-            child.cost = 0;
-            child.possible_cost = 0;
+        child.actors = solution.actors;
+        child.cost = 0;
+        child.possible_cost = 0;
+    }
+    for (int j = 0; j < actors_num_lkup; ++j) {
+        if (child.actors[j].complete) {
+            child.cost += child.actors[j].cost;
+            continue;
         }
-        for (int j = 0; j < actors_num_lkup; ++j) {
-            if (child.actors[j].complete) {
-                child.cost += child.actors[j].cost;
-                continue;
-            }
 
-            if (insert_start) {
-                if (actors_scenes_lkup[j][solution.avaible_scenes[i]]) {
-                    child.actors[j].filmed_scenes++;
-                    if (child.actors[j].start == -1) {
-                        child.actors[j].start = (int) child.start_scenes.size();
-                    }
-                    if (child.actors[j].end == -1 &&
-                        !(actors_lkup[j].total_scenes - child.actors[j].filmed_scenes)) {
-                        child.actors[j].end = (int) child.start_scenes.size();
-                    }
+        if (insert_start) {
+            if (instance_lkup->on_scene(j, solution.avaible_scenes[i])) {
+                child.actors[j].filmed_scenes++;
+                if (child.actors[j].start == -1) {
+                    child.actors[j].start = (int) child.start_scenes.size();
                 }
-            } else {
-                if (actors_scenes_lkup[j][solution.avaible_scenes[i]]) {
-                    child.actors[j].filmed_scenes++;
-                    if (child.actors[j].end == -1) {
-                        child.actors[j].end = (int) (days_num_lkup - (int) child.end_scenes.size()) + 1;
-                    }
-                    if (child.actors[j].start == -1 && !(actors_lkup[j].total_scenes - child.actors[j].filmed_scenes)) {
-                        child.actors[j].start = (int) (days_num_lkup - (int) child.end_scenes.size()) + 1;
-                    }
+                if (child.actors[j].end == -1 &&
+                    !(actors_lkup[j].total_scenes - child.actors[j].filmed_scenes)) {
+                    child.actors[j].end = (int) child.start_scenes.size();
                 }
             }
-            if (child.actors[j].start != -1) {
+        } else {
+            if (instance_lkup->on_scene(j, solution.avaible_scenes[i])) {
+                child.actors[j].filmed_scenes++;
                 if (child.actors[j].end == -1) {
-                    child.actors[j].cost =
-                            (((child.start_scenes.size() - child.actors[j].start) - child.actors[j].filmed_scenes) +
-                             1) *
-                            actors_lkup[j].cost;
-                } else {
-                    child.actors[j].cost =
-                            (((child.actors[j].end - child.actors[j].start) - actors_lkup[j].total_scenes) + 1) *
-                            actors_lkup[j].cost;
-                    child.actors[j].complete = true;
+                    child.actors[j].end = (int) (days_num_lkup - (int) child.end_scenes.size()) + 1;
                 }
-            } else {
-                if (child.actors[j].end != -1) {
-                    child.actors[j].cost =
-                            ((child.actors[j].end - ((days_num_lkup - (int) child.end_scenes.size()) + 1)) -
-                             child.actors[j].filmed_scenes + 1) * actors_lkup[j].cost;
+                if (child.actors[j].start == -1 && !(actors_lkup[j].total_scenes - child.actors[j].filmed_scenes)) {
+                    child.actors[j].start = (int) (days_num_lkup - (int) child.end_scenes.size()) + 1;
                 }
             }
-            child.cost += child.actors[j].cost;
         }
-
-        // calculate a min sum for the avaible scenes
-        vector<int> open_start, open_end;
-        for (int l = 0; l < actors_num_lkup; ++l) {
-            if (child.actors[l].start != -1 && child.actors[l].end == -1) {
-                open_start.push_back(l);
-            } else if (child.actors[l].end != -1 && child.actors[l].start == -1) {
-                open_end.push_back(l);
+        if (child.actors[j].start != -1) {
+            if (child.actors[j].end == -1) {
+                child.actors[j].cost =
+                        (((child.start_scenes.size() - child.actors[j].start) - child.actors[j].filmed_scenes) +
+                         1) *
+                        actors_lkup[j].cost;
+            } else {
+                child.actors[j].cost =
+                        (((child.actors[j].end - child.actors[j].start) - actors_lkup[j].total_scenes) + 1) *
+                        actors_lkup[j].cost;
+                child.actors[j].complete = true;
+            }
+        } else {
+            if (child.actors[j].end != -1) {
+                child.actors[j].cost =
+                        ((child.actors[j].end - ((days_num_lkup - (int) child.end_scenes.size()) + 1)) -
+                         child.actors[j].filmed_scenes + 1) * actors_lkup[j].cost;
             }
         }
+        child.cost += child.actors[j].cost;
+    }
+    return true;
+}
 
-        priority_queue<OrderedScene> ordered_scenes_start, ordered_scenes_end;
-        for (int k = 0; k < child.avaible_scenes.size(); ++k) {
-            unsigned long start_cost = 0, end_cost = 0;
-            for (int j = 0; j < open_start.size(); ++j) {
-                if (actors_scenes_lkup[open_start[j]][child.avaible_scenes[k]]) {
-                    start_cost += actors_lkup[open_start[j]].cost;
-                }
+unsigned long astar_estimate(const Solution &solution) {
+    unsigned long start_min = ULONG_MAX, end_min = ULONG_MAX;
+    for (int k = 0; k < solution.avaible_scenes.size(); ++k) {
+        unsigned long start_cost = 0, end_cost = 0;
+        for (int j = 0; j < actors_num_lkup; ++j) {
+            const Actor &actor = solution.actors[j];
+            if (actor.complete || instance_lkup->on_scene(j, solution.avaible_scenes[k])) continue;
+            if (actor.start != -1 && actor.end == -1) {
+                start_cost += actors_lkup[j].cost;
+            } else if (actor.end != -1 && actor.start == -1) {
+                end_cost += actors_lkup[j].cost;
             }
+        }
+        start_min = min(start_min, start_cost);
+        end_min = min(end_min, end_cost);
+    }
+    return solution.avaible_scenes.empty() ? 0 : start_min + end_min;
+}
 
-            for (int j = 0; j < open_end.size(); ++j) {
-                if (actors_scenes_lkup[open_end[j]][child.avaible_scenes[k]]) {
-                    start_cost += actors_lkup[open_end[j]].cost;
-                }
-            }
+void init_root(Solution &root) {
+    root.cost = 0;
+    root.possible_cost = 0;
+    root.reduced_cost = 0;
+    root.lp_distance = 0;
+    root.start_scenes.clear();
+    root.end_scenes.clear();
+    root.avaible_scenes.clear();
+    for (int j = 0; j < days_num_lkup; ++j) {
+        root.avaible_scenes.push_back(j);
+    }
+    root.actors = vector<Actor>(actors_num_lkup);
+    for (int k = 0; k < actors_num_lkup; ++k) {
+        root.actors[k].start = -1;
+        root.actors[k].end = -1;
+        root.actors[k].filmed_scenes = 0;
+        root.actors[k].cost = 0;
+        root.actors[k].complete = false;
+        root.actors[k].id = -1;
+    }
+}
 
-            OrderedScene start_scene, end_scene;
-            start_scene.scene = end_scene.scene = child.avaible_scenes[k];
-            start_scene.cost = start_cost;
-            end_scene.cost = end_cost;
-            ordered_scenes_start.push(start_scene);
-            ordered_scenes_end.push(end_scene);
+/**
+ * Makes the schedule the incumbent, the problem is solved if it reaches the root bound. source names
+ * the search that found it on the trajectory
+ */
+void update_incumbent(const vector<int> &scene_order, unsigned long cost, const char *source) {
+    if (cost >= max_cost) return;
+    max_cost = cost;
+    result->scene_order = scene_order;
+    result->cost = max_cost;
+    record_improvement(*result, wall_seconds() - start_time, source);
+    if (channel != NULL) {
+        channel_publish(channel, max_cost, &result->scene_order[0], (int) result->scene_order.size(), "bnb");
+    }
+    // the incumbent reached the root bound, so it is optimal
+    if (max_cost <= min_cost) {
+        solved = true;
+        result->bound = max_cost;
+        result->optimal = true;
+        if (channel != NULL) {
+            channel_publish_bound(channel, max_cost);
         }
+    }
+    publish_incumbent(*result);
+}
 
-        vector<bool> selected_start(actors_num_lkup), selected_end(actors_num_lkup);
-        vector<int> selected_start_scenes, selected_end_scenes;
-        for (int m = 0; m < child.avaible_scenes.size(); ++m) {
-            bool valid_start_scene = false;
-            for (int j = 0; j < open_start.size(); ++j) {
-                if (actors_scenes_lkup[open_start[j]][ordered_scenes_start.top().scene]) {
-                    if (selected_start[open_start[j]]) {
-                        valid_start_scene = false;
-                        break;
-                    }
-                    valid_start_scene = true;
-                }
-            }
-            if (valid_start_scene) {
-                selected_start_scenes.push_back(ordered_scenes_start.top().scene);
-                for (int j = 0; j < open_start.size(); ++j) {
-                    if (actors_scenes_lkup[open_start[j]][ordered_scenes_start.top().scene]) {
-                        selected_start[open_start[j]] = true;
-                    }
+void update_incumbent(const Solution &solution, const char *source) {
+    vector<int> scene_order = solution.start_scenes;
+    scene_order.insert(scene_order.end(), solution.end_scenes.begin(), solution.end_scenes.end());
+    update_incumbent(scene_order, solution.cost, source);
+}
+
+/**
+ * First improvement local search on the schedule, swapping two scenes or moving a scene to another
+ * position until no move lowers the cost
+ * @return the cost of the improved schedule
+ */
+unsigned long improve_order(vector<int> &scene_order, unsigned long cost) {
+    bool improved = true;
+    while (improved && !engine_stop(deadline)) {
+        improved = false;
+        for (int i = 0; i < scene_order.size(); ++i) {
+            for (int j = i + 1; j < scene_order.size(); ++j) {
+                swap(scene_order[i], scene_order[j]);
+                unsigned long swapped_cost = schedule_cost(*instance_lkup, scene_order);
+                if (swapped_cost < cost) {
+                    cost = swapped_cost;
+                    improved = true;
+                    continue;
                 }
-            };
-            ordered_scenes_start.pop();
-
-            bool valid_end_scene = false;
-            for (int j = 0; j < open_end.size(); ++j) {
-                if (actors_scenes_lkup[open_end[j]][ordered_scenes_end.top().scene]) {
-                    if (selected_end[open_end[j]]) {
-                        valid_end_scene = false;
-                        break;
-                    }
-                    valid_end_scene = true;
+                swap(scene_order[i], scene_order[j]);
+                rotate(scene_order.begin() + i, scene_order.begin() + i + 1, scene_order.begin() + j + 1);
+                unsigned long moved_cost = schedule_cost(*instance_lkup, scene_order);
+                if (moved_cost < cost) {
+                    cost = moved_cost;
+                    improved = true;
+                    continue;
                 }
+                rotate(scene_order.begin() + i, scene_order.begin() + j, scene_order.begin() + j + 1);
             }
-            if (valid_end_scene) {
-                selected_end_scenes.push_back(ordered_scenes_end.top().scene);
-                for (int j = 0; j < open_end.size(); ++j) {
-                    if (actors_scenes_lkup[open_end[j]][ordered_scenes_end.top().scene]) {
-                        selected_end[open_end[j]] = true;
-                    }
-                }
-            };
-            ordered_scenes_end.pop();
-        }
-        vector<Actor> estimated_start_scenes_actors_cost;
-        for (int n = 0; n < open_start.size(); ++n) {
-            Actor actor;
-            actor.id = open_start[n];
-            actor.cost = 0;
-            actor.filmed_scenes = solution.actors[open_start[n]].filmed_scenes;
         }
-        for (int n = 0; n < selected_start_scenes.size(); ++n) {
-            for (int j = 0; j < estimated_start_scenes_actors_cost.size(); ++j) {
-                if (actors_scenes_lkup[estimated_start_scenes_actors_cost[j].id][selected_start_scenes[n]]) {
-                    estimated_start_scenes_actors_cost[j].filmed_scenes++;
-                } else {
-                    if (estimated_start_scenes_actors_cost[j].filmed_scenes <
-                        actors_lkup[estimated_start_scenes_actors_cost[j].id].total_scenes) {
-                        estimated_start_scenes_actors_cost[j].cost += actors_lkup[estimated_start_scenes_actors_cost[j].id].cost;
-                    }
-                }
+    }
+    return cost;
+}
+
+/**
+ * Completes the solution taking on every level the child of least cost plus astar_estimate, then
+ * improves the schedule with improve_order
+ * @return true if it improved the incumbent
+ */
+bool dive(const Solution &solution) {
+    Solution current = solution;
+    while (!current.avaible_scenes.empty()) {
+        bool insert_start = current.end_scenes.size() >= current.start_scenes.size();
+        Solution best;
+        unsigned long best_bound = ULONG_MAX;
+        for (int i = 0; i < current.avaible_scenes.size(); ++i) {
+            Solution child;
+            if (!expand_child(current, i, insert_start, child)) continue;
+            unsigned long bound = child.cost + astar_estimate(child);
+            if (bound < best_bound) {
+                best_bound = bound;
+                swap(best, child);
             }
         }
-        for (int n = 0; n < estimated_start_scenes_actors_cost.size(); ++n) {
-            child.possible_cost += estimated_start_scenes_actors_cost[n].cost;
-        }
+        if (best_bound >= prune_cost()) return false;
+        swap(current, best);
+    }
+    vector<int> scene_order = current.start_scenes;
+    scene_order.insert(scene_order.end(), current.end_scenes.begin(), current.end_scenes.end());
+    unsigned long cost = improve_order(scene_order, current.cost);
+    if (cost >= prune_cost()) return false;
+    update_incumbent(scene_order, cost, "dive");
+    return true;
+}
+
+unsigned long long scenes_mask(const vector<int> &scenes) {
+    unsigned long long mask = 0;
+    for (int k = 0; k < scenes.size(); ++k) {
+        mask |= 1ULL << scenes[k];
+    }
+    return mask;
+}
 
-        vector<Actor> estimated_end_scenes_actors_cost;
-        for (int n = 0; n < open_end.size(); ++n) {
-            Actor actor;
-            actor.id = open_end[n];
-            actor.cost = 0;
-            actor.filmed_scenes = solution.actors[open_end[n]].filmed_scenes;
+/**
+ * Least cost of shooting the available scenes of the solution between its start and its end. Shooting a
+ * scene after the set S of the middle costs the actors on location and not on it: those with a scene on
+ * the start or on S and another on the end or on the rest of the middle. Complete actors already paid.
+ * Sets reaching limit are pruned, if the whole middle does the entry is left with limit as its bound
+ */
+void solve_middle(const Solution &solution, unsigned long limit, LeafEntry &entry) {
+    const vector<int> &scenes = solution.avaible_scenes;
+    unsigned long words = instance_lkup->actors_words;
+    vector<unsigned long long> start_open(words, 0), end_open(words, 0), counted(words, 0);
+    for (int j = 0; j < actors_num_lkup; ++j) {
+        const Actor &actor = solution.actors[j];
+        if (actor.complete) continue;
+        counted[j / 64] |= 1ULL << (j % 64);
+        if (actor.start != -1) start_open[j / 64] |= 1ULL << (j % 64);
+        if (actor.end != -1) end_open[j / 64] |= 1ULL << (j % 64);
+    }
+    // actors of each subset of the middle, built from the subset without its lowest scene
+    size_t sets = (size_t) 1 << scenes.size();
+    vector<unsigned long long> unions(sets * words, 0);
+    for (size_t set = 1; set < sets; ++set) {
+        const unsigned long long *row = instance_lkup->scene_row(scenes[__builtin_ctzll(set)]);
+        const unsigned long long *previous = &unions[(set & (set - 1)) * words];
+        for (unsigned long w = 0; w < words; ++w) {
+            unions[set * words + w] = previous[w] | row[w];
+        }
+    }
+    vector<unsigned long> costs(sets, ULONG_MAX);
+    vector<int> last(sets, -1);
+    vector<unsigned long long> open(words);
+    costs[0] = 0;
+    for (size_t set = 0; set + 1 < sets; ++set) {
+        if (costs[set] >= limit) continue;
+        size_t rest = (sets - 1) ^ set;
+        for (unsigned long w = 0; w < words; ++w) {
+            open[w] = counted[w] & (start_open[w] | unions[set * words + w]) & (end_open[w] | unions[rest * words + w]);
         }
-        for (int n = 0; n < selected_end_scenes.size(); ++n) {
-            for (int j = 0; j < estimated_end_scenes_actors_cost.size(); ++j) {
-                if (actors_scenes_lkup[estimated_end_scenes_actors_cost[j].id][selected_end_scenes[n]]) {
-                    estimated_end_scenes_actors_cost[j].filmed_scenes++;
-                } else {
-                    if (estimated_end_scenes_actors_cost[j].filmed_scenes <
-                        actors_lkup[estimated_end_scenes_actors_cost[j].id].total_scenes) {
-                        estimated_end_scenes_actors_cost[j].cost += actors_lkup[estimated_end_scenes_actors_cost[j].id].cost;
-                    }
+        for (size_t remaining = rest; remaining; remaining &= remaining - 1) {
+            int k = __builtin_ctzll(remaining);
+            const unsigned long long *row = instance_lkup->scene_row(scenes[k]);
+            unsigned long cost = costs[set];
+            for (unsigned long w = 0; w < words; ++w) {
+                for (unsigned long long bits = open[w] & ~row[w]; bits; bits &= bits - 1) {
+                    cost += instance_lkup->actors_cost[w * 64 + __builtin_ctzll(bits)];
                 }
             }
+            size_t child = set | ((size_t) 1 << k);
+            if (cost < limit && cost < costs[child]) {
+                costs[child] = cost;
+                last[child] = k;
+            }
         }
-        for (int n = 0; n < estimated_end_scenes_actors_cost.size(); ++n) {
-            child.possible_cost += estimated_end_scenes_actors_cost[n].cost;
+    }
+    entry.order.clear();
+    if (costs[sets - 1] >= limit) {
+        entry.cost = limit;
+        return;
+    }
+    entry.cost = costs[sets - 1];
+    entry.order.resize(scenes.size());
+    for (size_t set = sets - 1; set; set &= ~((size_t) 1 << last[set])) {
+        entry.order[__builtin_popcountll(set) - 1] = scenes[last[set]];
+    }
+}
+
+/**
+ * Finishes the solution with the best middle of its scene sets, computed once per pair of sets
+ */
+void solve_leaf(const Solution &solution) {
+    pair<unsigned long long, unsigned long long> masks(scenes_mask(solution.start_scenes),
+                                                       scenes_mask(solution.end_scenes));
+    // only middles cheaper than this improve the incumbent, the shared one may have dropped below the node
+    unsigned long incumbent = prune_cost();
+    if (solution.cost >= incumbent) return;
+    unsigned long limit = incumbent - solution.cost;
+    LeafTable::iterator it = leaves.find(masks);
+    if (it == leaves.end()) {
+        if (leaves.size() >= leaf_max_entries) leaves.clear();
+        it = leaves.insert(make_pair(masks, LeafEntry())).first;
+        solve_middle(solution, limit, it->second);
+    } else if (it->second.order.empty() && it->second.cost < limit) {
+        solve_middle(solution, limit, it->second);
+    }
+    if (it->second.order.empty() || it->second.cost >= limit) return;
+    unsigned long cost = solution.cost + it->second.cost;
+    vector<int> scene_order = solution.start_scenes;
+    scene_order.insert(scene_order.end(), it->second.order.begin(), it->second.order.end());
+    scene_order.insert(scene_order.end(), solution.end_scenes.begin(), solution.end_scenes.end());
+    update_incumbent(scene_order, cost, "leaf");
+}
+
+/**
+ * Adjacent swap test: the child is dominated if exchanging its new scene with the scene placed before it on
+ * the same side strictly lowers its cost, both orders have the same scene sets and so the same completions
+ */
+bool swap_dominated(const Solution &child, bool insert_start) {
+    const vector<int> &side = insert_start ? child.start_scenes : child.end_scenes;
+    if (side.size() < 2) return false;
+    // placed is the new scene, previous the one between it and the border of the schedule
+    int placed = insert_start ? side.back() : side[0];
+    int previous = insert_start ? side[side.size() - 2] : side[1];
+    int position = insert_start ? (int) side.size() : (int) (days_num_lkup - side.size()) + 1;
+    long delta = 0;
+    for (int j = 0; j < actors_num_lkup; ++j) {
+        const Actor &actor = child.actors[j];
+        bool on_placed = instance_lkup->on_scene(j, placed);
+        bool on_previous = instance_lkup->on_scene(j, previous);
+        if (!on_placed && !on_previous) continue;
+        // the actor has a scene beyond previous, or one past placed towards the middle of the schedule
+        bool outer = insert_start ? actor.start != -1 && actor.start < position - 1 :
+                     actor.end != -1 && actor.end > position + 1;
+        bool inner = actors_lkup[j].total_scenes > actor.filmed_scenes ||
+                     (insert_start ? actor.end != -1 && actor.end > position :
+                      actor.start != -1 && actor.start < position);
+        int waits = (!on_previous && outer && (on_placed || inner)) + (!on_placed && (outer || on_previous) && inner);
+        int swapped_waits = (!on_placed && outer && (on_previous || inner)) +
+                            (!on_previous && (outer || on_placed) && inner);
+        delta += (long) (swapped_waits - waits) * (long) actors_lkup[j].cost;
+    }
+    return delta < 0;
+}
+
+/**
+ * Open actors test: an available scene whose actors not yet complete are exactly the actors open on the
+ * side costs nothing to shoot next and never lengthens a stay, some optimal completion places it there
+ * @return the index of such a scene on avaible_scenes, -1 if there is none
+ */
+int forced_scene(const Solution &solution, bool insert_start) {
+    for (int i = 0; i < solution.avaible_scenes.size(); ++i) {
+        int j = 0;
+        for (; j < actors_num_lkup; ++j) {
+            const Actor &actor = solution.actors[j];
+            if (actor.complete) continue;
+            bool open = insert_start ? actor.start != -1 : actor.end != -1;
+            if (open != instance_lkup->on_scene(j, solution.avaible_scenes[i])) break;
         }
+        if (j == actors_num_lkup) return i;
+    }
+    return -1;
+}
 
+void solve(Solution solution) {
+    result->nodes++;
+    if (engine_stop(deadline)) {
+        stopped = true;
+        return;
+    }
+    // verifies if it is a complete, it will only enter the function if solution.cost < max_cost
+    if (solution.avaible_scenes.size() == 0) {
+        update_incumbent(solution, "bnb");
+        return;
+    }
+    if (solution.avaible_scenes.size() <= leaf_scenes) {
+        solve_leaf(solution);
+        return;
+    }
+    // dives more often while they find better incumbents
+    if (dive_enabled && result->nodes >= next_dive) {
+        dive_interval = dive(solution) ? max(dive_min_interval, dive_interval / 2) :
+                        min(dive_max_interval, dive_interval * 2);
+        next_dive = result->nodes + dive_interval;
+    }
+
+    // verifies if should insert start or end
+    bool insert_start = solution.end_scenes.size() >= solution.start_scenes.size();
+    // a scene that dominates the others on the side is the only child
+    int forced = dominance_enabled ? forced_scene(solution, insert_start) : -1;
+    for (int i = 0; i < solution.avaible_scenes.size(); ++i) {
+        if (forced != -1 && i != forced) continue;
+        Solution child;
+        if (!expand_child(solution, i, insert_start, child)) continue;
+        if (dominance_enabled && swap_dominated(child, insert_start)) continue;
+        child.possible_cost = astar_estimate(child);
+        if (child.cost + child.possible_cost >= prune_cost()) continue;
         solution.solutions.push(child);
     }
-    // explore sons
-    while (!solution.solutions.empty() && solution.solutions.top().cost < max_cost) {
+    // explore sons, by bound
+    while (!solved && !stopped && !solution.solutions.empty() &&
+           solution.solutions.top().cost + solution.solutions.top().possible_cost < prune_cost()) {
         solve(solution.solutions.top());
         solution.solutions.pop();
     }
 }
 
-void stop_execution(int signum) {
-    should_stop = true;
-    if(!best_solution_updating) {
-        print_formatted_result();
-        exit(0);
+/**
+ * Rebuilds the solution of an A* node replaying its placements from the root
+ * @return false if a placement is now pruned by the root LP reduced costs
+ */
+bool rebuild_solution(const vector<AstarNode> &nodes, int node, Solution &solution) {
+    vector<int> path;
+    for (int k = node; k > 0; k = nodes[k].parent) {
+        path.push_back(k);
+    }
+    init_root(solution);
+    for (int p = (int) path.size() - 1; p >= 0; --p) {
+        const AstarNode &placement = nodes[path[p]];
+        int i = (int) (find(solution.avaible_scenes.begin(), solution.avaible_scenes.end(), placement.scene) -
+                       solution.avaible_scenes.begin());
+        Solution child;
+        if (!expand_child(solution, i, placement.insert_start, child)) return false;
+        swap(solution, child);
+    }
+    return true;
+}
+
+/**
+ * A* over the placements, the nodes are expanded by bound with the same children as solve(). A child
+ * is discarded when the same start and end sets were already reached at a lower or equal cost
+ */
+void solve_astar() {
+    vector<AstarNode> nodes(1);
+    nodes[0].parent = -1;
+    nodes[0].scene = -1;
+    nodes[0].insert_start = true;
+    nodes[0].cost = 0;
+    priority_queue<OpenNode> open;
+    OpenNode root;
+    root.bound = 0;
+    root.depth = 0;
+    root.node = 0;
+    open.push(root);
+    closed.clear();
+    closed[make_pair(0ULL, 0ULL)] = 0;
+    while (!solved && !open.empty() && open.top().bound < prune_cost()) {
+        result->nodes++;
+        if (engine_stop(deadline) || nodes.size() > astar_max_nodes) {
+            stopped = true;
+            return;
+        }
+        OpenNode top = open.top();
+        open.pop();
+        Solution solution;
+        if (!rebuild_solution(nodes, top.node, solution)) continue;
+        // a cheaper order of the same sets was reached after this node was generated
+        pair<unsigned long long, unsigned long long> masks(scenes_mask(solution.start_scenes),
+                                                           scenes_mask(solution.end_scenes));
+        if (closed[masks] < solution.cost) continue;
+        // every node still open is above the bound of the top one
+        if (top.bound > result->bound) {
+            result->bound = top.bound;
+            publish_incumbent(*result);
+        }
+
+        bool insert_start = solution.end_scenes.size() >= solution.start_scenes.size();
+        for (int i = 0; i < solution.avaible_scenes.size(); ++i) {
+            Solution child;
+            if (!expand_child(solution, i, insert_start, child) || child.cost >= prune_cost()) continue;
+            if (child.avaible_scenes.empty()) {
+                update_incumbent(child, "astar");
+                continue;
+            }
+            pair<unsigned long long, unsigned long long> child_masks(scenes_mask(child.start_scenes),
+                                                                     scenes_mask(child.end_scenes));
+            ClosedTable::iterator reached = closed.find(child_masks);
+            if (reached != closed.end() && reached->second <= child.cost) continue;
+            OpenNode entry;
+            entry.bound = child.cost + astar_estimate(child);
+            if (entry.bound >= prune_cost()) continue;
+            closed[child_masks] = child.cost;
+            AstarNode node;
+            node.parent = top.node;
+            node.scene = solution.avaible_scenes[i];
+            node.insert_start = insert_start;
+            node.cost = child.cost;
+            entry.depth = top.depth + 1;
+            entry.node = (int) nodes.size();
+            nodes.push_back(node);
+            open.push(entry);
+        }
     }
 }
 
 
 /**
- * Main function, organize the algorithm flow
- * @param argc num of arguments on the command line
- * @param argv argv[1] contains the path of the entry_file
- * @return 0 in case of success
+ * Depth of a beam pass shared by the threads expanding it, with the data of the leader thread the
+ * workers copy to their own
+ */
+typedef struct BeamDepth {
+    const vector<Solution> *beam;
+    bool insert_start;
+    atomic<size_t> next;
+    const Instance *instance;
+    unsigned long prune_cost;
+    bool root_loaded;
+    double root_bound;
+    unsigned long min_cost;
+    const vector<double> *root_positions;
+    const vector<vector<double> > *root_reduced_costs;
+} BeamDepth;
+
+/**
+ * Expands the solutions of the beam taken from depth.next into children, ranked by their cost plus
+ * astar_estimate
  */
-int main(int argc, const char *argv[]) {
-    // register signal
-    signal(SIGINT, stop_execution);
-    // data declaration
-    unsigned long days_num, actors_num;
-
-    // open file on argv[1]
-    ifstream entry_file;
-    entry_file.open(argv[1]);
-    if (!entry_file) {
-        cerr << "Não foi possível abrir o arquivo de entrada " << argv[1];
-        exit(1);
-    }
-
-    // read data from file
-    entry_file >> days_num;
-    entry_file >> actors_num;
-
-    // read scenes requirements
-    vector<vector<int> > actors_scenes(actors_num, vector<int>(days_num));
-    for (int actor = 0; actor < actors_num; ++actor) {
-        for (int day = 0; day < days_num; ++day) {
-            entry_file >> actors_scenes[actor][day];
+void expand_beam(BeamDepth &depth, vector<Solution> &children, bool leader) {
+    if (!leader) {
+        init_data(*depth.instance);
+        max_cost = depth.prune_cost;
+        channel = NULL;
+        root_loaded = depth.root_loaded;
+        root_bound = depth.root_bound;
+        min_cost = depth.min_cost;
+        root_positions = *depth.root_positions;
+        root_reduced_costs = *depth.root_reduced_costs;
+    }
+    const vector<Solution> &beam = *depth.beam;
+    size_t k;
+    while ((k = depth.next++) < beam.size()) {
+        for (int i = 0; i < beam[k].avaible_scenes.size(); ++i) {
+            Solution child;
+            if (!expand_child(beam[k], i, depth.insert_start, child) || child.cost >= depth.prune_cost) continue;
+            child.possible_cost = astar_estimate(child);
+            if (child.cost + child.possible_cost >= depth.prune_cost) continue;
+            children.push_back(child);
         }
     }
+}
 
-    // read actor cost
-    vector<unsigned long> actors_cost(actors_num);
-    for (int i = 0; i < actors_num; ++i) {
-        entry_file >> actors_cost[i];
+/**
+ * Child of a beam depth, the children are sorted by sets to keep the cheapest order of each and then
+ * by bound to keep the best ones
+ */
+typedef struct BeamChild {
+    unsigned long long start_mask;
+    unsigned long long end_mask;
+    const Solution *solution;
+
+    bool operator<(const BeamChild &compareTo) const {
+        if (start_mask != compareTo.start_mask) return start_mask < compareTo.start_mask;
+        if (end_mask != compareTo.end_mask) return end_mask < compareTo.end_mask;
+        return solution->cost < compareTo.solution->cost;
+    }
+} BeamChild;
+
+bool same_sets(const BeamChild &first, const BeamChild &second) {
+    return first.start_mask == second.start_mask && first.end_mask == second.end_mask;
+}
+
+bool better_bound(const BeamChild &first, const BeamChild &second) {
+    return *second.solution < *first.solution;
+}
+
+/**
+ * Beam pass of the given width from the root, the leaves found update the incumbent
+ * @return false if some depth had more children than the width, so the pass was not exhaustive
+ */
+bool beam_pass(size_t width) {
+    vector<Solution> beam(1);
+    init_root(beam[0]);
+    vector<vector<Solution> > children(threads_num);
+    bool exhaustive = true;
+    for (unsigned long placed = 0; placed < days_num_lkup && !beam.empty(); ++placed) {
+        result->nodes += beam.size();
+        if (engine_stop(deadline)) {
+            stopped = true;
+            return false;
+        }
+        BeamDepth depth;
+        depth.beam = &beam;
+        depth.insert_start = beam[0].end_scenes.size() >= beam[0].start_scenes.size();
+        depth.next = 0;
+        depth.instance = instance_lkup;
+        depth.prune_cost = prune_cost();
+        depth.root_loaded = root_loaded;
+        depth.root_bound = root_bound;
+        depth.min_cost = min_cost;
+        depth.root_positions = &root_positions;
+        depth.root_reduced_costs = &root_reduced_costs;
+        vector<thread> workers;
+        for (unsigned int t = 1; t < threads_num; ++t) {
+            workers.push_back(thread(expand_beam, ref(depth), ref(children[t]), false));
+        }
+        expand_beam(depth, children[0], true);
+        for (int t = 0; t < workers.size(); ++t) {
+            workers[t].join();
+        }
+
+        vector<BeamChild> ranked;
+        for (int t = 0; t < children.size(); ++t) {
+            for (int c = 0; c < children[t].size(); ++c) {
+                BeamChild child;
+                child.start_mask = days_num_lkup <= 64 ? scenes_mask(children[t][c].start_scenes) : 0;
+                child.end_mask = days_num_lkup <= 64 ? scenes_mask(children[t][c].end_scenes) : c + 1;
+                child.solution = &children[t][c];
+                ranked.push_back(child);
+            }
+        }
+        // every order of the same sets has the same completions, only the cheapest one is kept
+        if (days_num_lkup <= 64) {
+            sort(ranked.begin(), ranked.end());
+            ranked.erase(unique(ranked.begin(), ranked.end(), same_sets), ranked.end());
+        }
+        if (ranked.size() > width) {
+            nth_element(ranked.begin(), ranked.begin() + width, ranked.end(), better_bound);
+            ranked.resize(width);
+            exhaustive = false;
+        }
+        vector<Solution> next(ranked.size());
+        for (int c = 0; c < ranked.size(); ++c) {
+            next[c] = *ranked[c].solution;
+        }
+        for (int t = 0; t < children.size(); ++t) {
+            children[t].clear();
+        }
+        beam.swap(next);
+    }
+    if (!beam.empty()) {
+        const Solution &best = *max_element(beam.begin(), beam.end());
+        if (best.cost < prune_cost()) update_incumbent(best, "beam");
+    }
+    return exhaustive;
+}
+
+/**
+ * Beam search: passes of doubling width while the next one is expected to end before the deadline. A
+ * pass that kept every child proves the incumbent optimal
+ */
+void solve_beam() {
+    for (size_t width = beam_width; !solved; width *= 2) {
+        double pass_start = wall_seconds();
+        if (beam_pass(width)) return;
+        if (stopped) return;
+        double pass_time = wall_seconds() - pass_start;
+        if (width >= beam_max_width || (deadline > 0 && wall_seconds() + 2 * pass_time > deadline)) {
+            // the search ends without a proof
+            stopped = true;
+            return;
+        }
+    }
+}
+
+}
+
+using namespace bnb;
+
+/**
+ * Components of an instance solved apart. A part is finished once its run returned, the schedule of
+ * the unfinished ones is their original order
+ */
+typedef struct Decomposition {
+    const vector<vector<int> > *components;
+    vector<Instance> parts;
+    vector<EngineResult> results;
+    vector<bool> finished;
+    double start_time;
+    mutex lock;
+} Decomposition;
+
+/**
+ * Concatenates the schedules of the parts into run_result and records it when it improves, the bound
+ * of an unfinished part is 0. Called under the decomposition lock
+ */
+void combine_parts(Decomposition &decomposition, EngineResult &run_result) {
+    const vector<vector<int> > &components = *decomposition.components;
+    unsigned long cost = 0;
+    run_result.scene_order.clear();
+    run_result.bound = 0;
+    run_result.nodes = 0;
+    run_result.optimal = true;
+    for (int k = 0; k < components.size(); ++k) {
+        const Instance &part_instance = decomposition.parts[k];
+        EngineResult &part = decomposition.results[k];
+        // a component not finished or stopped before its first incumbent is shot in its original order
+        vector<int> original;
+        const vector<int> *part_order = &part.scene_order;
+        unsigned long part_cost = part.cost;
+        if (!decomposition.finished[k] || part.cost == ULONG_MAX) {
+            original.resize(components[k].size());
+            for (int l = 0; l < original.size(); ++l) {
+                original[l] = l;
+            }
+            part_order = &original;
+            part_cost = schedule_cost(part_instance, original);
+        }
+        for (int l = 0; l < part_order->size(); ++l) {
+            run_result.scene_order.push_back(components[k][(*part_order)[l]]);
+        }
+        cost += part_cost;
+        if (decomposition.finished[k]) {
+            run_result.bound += part.bound;
+            run_result.nodes += part.nodes;
+        }
+        run_result.optimal = run_result.optimal && decomposition.finished[k] && part.optimal;
+    }
+    if (cost < run_result.cost) {
+        run_result.cost = cost;
+        record_improvement(run_result, wall_seconds() - decomposition.start_time, "components");
+    }
+    if (run_result.optimal) run_result.bound = run_result.cost;
+}
+
+/**
+ * Solves the next parts with threads of the budget, publishing the combined schedule after each one
+ * since the runs of the parts do not publish theirs
+ */
+void solve_parts(Decomposition &decomposition, const vector<string> &args, unsigned int threads, double run_deadline,
+                 atomic<size_t> &next_part, EngineResult &run_result) {
+    vector<string> part_args(args);
+    part_args.push_back("--threads");
+    part_args.push_back(to_string(threads));
+    size_t k;
+    while ((k = next_part++) < decomposition.parts.size()) {
+        publishing_muted = true;
+        run_bnb(decomposition.parts[k], part_args, run_deadline, decomposition.results[k]);
+        publishing_muted = false;
+        lock_guard<mutex> lock(decomposition.lock);
+        decomposition.finished[k] = true;
+        combine_parts(decomposition, run_result);
+        publish_incumbent(run_result);
+    }
+}
+
+/**
+ * Solves the connected components of the instance apart, splitting the threads_num threads among up to
+ * threads_num parts at a time, and concatenates their schedules. The components share no actor, so the
+ * schedule is optimal when the schedule of every component is
+ */
+void solve_components(const Instance &instance, const vector<vector<int> > &components, const vector<string> &args,
+                      double run_deadline, EngineResult &run_result) {
+    Decomposition decomposition;
+    decomposition.components = &components;
+    decomposition.parts.resize(components.size());
+    decomposition.results.resize(components.size());
+    decomposition.finished.assign(components.size(), false);
+    decomposition.start_time = start_time;
+    for (int k = 0; k < components.size(); ++k) {
+        sub_instance(instance, components[k], decomposition.parts[k]);
+        reset_result(decomposition.results[k]);
+    }
+    combine_parts(decomposition, run_result);
+    publish_incumbent(run_result);
+
+    atomic<size_t> next_part(0);
+    unsigned int workers_num = (unsigned int) min((size_t) threads_num, components.size());
+    vector<thread> workers;
+    for (unsigned int t = 0; t < workers_num; ++t) {
+        unsigned int threads = threads_num / workers_num + (t < threads_num % workers_num ? 1 : 0);
+        workers.push_back(thread(solve_parts, ref(decomposition), cref(args), threads, run_deadline,
+                                 ref(next_part), ref(run_result)));
+    }
+    for (int t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+}
+
+bool run_bnb(const Instance &instance, const vector<string> &args, double run_deadline, EngineResult &run_result) {
+    reset_result(run_result);
+    result = &run_result;
+    deadline = run_deadline;
+    start_time = wall_seconds();
+    max_cost = ULONG_MAX;
+    solved = stopped = false;
+    root_loaded = false;
+    root_bound = 0;
+    min_cost = 0;
+    channel = NULL;
+    astar_enabled = false;
+    astar_max_nodes = 1 << 24;
+    beam_enabled = false;
+    beam_width = 1;
+    threads_num = max(1u, thread::hardware_concurrency());
+    // optional root LP from pli-solver --root, shared incumbent of a portfolio run, A* and beam modes
+    const char *root_path = NULL;
+    bool decompose = true;
+    dive_enabled = true;
+    dominance_enabled = true;
+    leaf_scenes = 12;
+    dive_interval = 1024;
+    next_dive = 0;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--no-decompose") {
+            decompose = false;
+        } else if (args[i] == "--no-dive") {
+            dive_enabled = false;
+        } else if (args[i] == "--no-dominance") {
+            dominance_enabled = false;
+        } else if (args[i] == "--leaf-dp" && i + 1 < args.size()) {
+            leaf_scenes = (unsigned long) min(16, max(0, atoi(args[++i].c_str())));
+        } else if (args[i] == "--astar") {
+            astar_enabled = true;
+        } else if (args[i] == "--beam") {
+            beam_enabled = true;
+        } else if (args[i] == "--beam-width" && i + 1 < args.size()) {
+            beam_width = (size_t) max(1L, atol(args[++i].c_str()));
+        } else if (args[i] == "--threads" && i + 1 < args.size()) {
+            threads_num = (unsigned int) max(1, atoi(args[++i].c_str()));
+        } else if (args[i] == "--astar-nodes" && i + 1 < args.size()) {
+            astar_max_nodes = (size_t) atol(args[++i].c_str());
+        } else if (args[i] == "--root" && i + 1 < args.size()) {
+            root_path = args[++i].c_str();
+        } else if (args[i] == "--shared" && i + 1 < args.size()) {
+            channel = channel_open(args[++i].c_str(), 0);
+        }
+    }
+    // independent parts of the instance are solved apart, the root LP and the shared incumbent are
+    // of the whole instance
+    if (decompose && root_path == NULL && channel == NULL) {
+        vector<vector<int> > components = scene_components(instance);
+        if (components.size() > 1) {
+            solve_components(instance, components, args, run_deadline, run_result);
+            return true;
+        }
     }
     // init solving problem
-    Solution empty_solution;
-    empty_solution.cost = 0;
-    for (int j = 0; j < days_num; ++j) {
-        empty_solution.avaible_scenes.push_back(j);
-    }
-    empty_solution.actors = vector<Actor>(actors_num);
-    for (int k = 0; k < actors_num; ++k) {
-        empty_solution.actors[k].start = -1;
-        empty_solution.actors[k].end = -1;
-        empty_solution.actors[k].filmed_scenes = 0;
-        empty_solution.actors[k].cost = 0;
-        empty_solution.actors[k].complete = false;
-        empty_solution.actors[k].id = -1;    }
-    init_data(days_num, actors_num, actors_scenes, actors_cost);
-    solve(empty_solution);
-    solved = true;
-    print_formatted_result();
-    return 0;
+    if (root_path != NULL && !read_root(root_path, instance.days_num)) {
+        cerr << "Não foi possível ler a raiz " << root_path << endl;
+        return false;
+    }
+    // if the problem isn't solved the bound is the root one, else the best solution was found
+    run_result.bound = min_cost;
+    init_data(instance);
+    if (astar_enabled && instance.days_num > 64) {
+        cerr << "O modo --astar resolve instâncias de até 64 cenas" << endl;
+        return false;
+    }
+    if (astar_enabled) {
+        solve_astar();
+        closed.clear();
+    } else if (beam_enabled) {
+        solve_beam();
+    } else {
+        // the leaf DP keys its table by scene masks
+        if (instance.days_num > 64) leaf_scenes = 0;
+        Solution empty_solution;
+        init_root(empty_solution);
+        solve(empty_solution);
+        leaves.clear();
+    }
+    if (!stopped && !solved) {
+        solved = true;
+        // the search is complete, nothing beats the shared incumbent, which is taken if it is better
+        unsigned long bound = prune_cost();
+        if (channel != NULL) {
+            channel_publish_bound(channel, bound);
+            if (bound < max_cost) {
+                vector<int> scene_order(CHANNEL_MAX_SCENES);
+                int scenes_num;
+                unsigned long cost = channel_read(channel, &scene_order[0], &scenes_num, NULL);
+                if (cost < max_cost && scenes_num == days_num_lkup) {
+                    scene_order.resize(scenes_num);
+                    update_incumbent(scene_order, cost, "shared");
+                }
+            }
+        }
+        run_result.bound = bound;
+        run_result.optimal = max_cost <= bound;
+        publish_incumbent(run_result);
+    }
+    if (channel != NULL) {
+        munmap(channel, sizeof(IncumbentChannel));
+        channel = NULL;
+    }
+    return true;
 }
@@ -0,0 +1,102 @@
+#ifndef BNB_H
+#define BNB_H
+
+#include <vector>
+#include <queue>
+#include "instance.h"
+
+/**
+ * Double-ended branch and bound: scenes are placed alternately on the start and on the end of the
+ * schedule. The search itself is run through run_bnb (engine.h), this exposes its steps to the
+ * benchmarks
+ */
+namespace bnb {
+/**
+ * Actor data definition
+ */
+typedef struct Actor {
+    int start;
+    int end;
+    int filmed_scenes;
+    unsigned long cost;
+    bool complete;
+    int id;
+} Actor;
+
+/**
+ * A solution
+ */
+typedef struct Solution {
+    std::vector<int> start_scenes;
+    std::vector<int> end_scenes;
+    std::vector<int> avaible_scenes;
+    unsigned long cost;
+    std::priority_queue<Solution> solutions;
+    std::vector<Actor> actors;
+    unsigned long possible_cost;
+    // sum of the LP reduced costs of the placements and distance of the last one to its LP day
+    double reduced_cost;
+    double lp_distance;
+
+    bool operator<(const Solution &compareTo) const {
+        if (possible_cost + cost == compareTo.possible_cost + compareTo.cost) {
+            return lp_distance > compareTo.lp_distance;
+        }
+        return possible_cost + cost > compareTo.possible_cost + compareTo.cost;
+    };
+
+} Solution;
+
+/**
+ * Node of the A* mode, the placement of a scene on its parent node. The solution of a node is rebuilt
+ * by replaying the placements from the root, so the open list only holds these
+ */
+typedef struct AstarNode {
+    int parent;
+    int scene;
+    bool insert_start;
+    unsigned long cost;
+} AstarNode;
+
+/**
+ * Entry of the A* open list, ordered by bound asc and then by depth desc
+ */
+typedef struct OpenNode {
+    unsigned long bound;
+    int depth;
+    int node;
+
+    bool operator<(const OpenNode &compareTo) const {
+        if (bound == compareTo.bound) {
+            return depth < compareTo.depth;
+        }
+        return bound > compareTo.bound;
+    }
+} OpenNode;
+
+/**
+ * Loads the lookups of the instance for the calling thread
+ */
+void init_data(const Instance &instance);
+
+/**
+ * The empty schedule, with every scene available
+ */
+void init_root(Solution &root);
+
+/**
+ * Creates the child of solution that places its i-th available scene on the start or on the end of
+ * the schedule and calculates its cost
+ * @return false if the child is pruned by the root LP reduced costs
+ */
+bool expand_child(const Solution &solution, int i, bool insert_start, Solution &child);
+
+/**
+ * Lower bound of the cost still to pay by the actors open on the solution: the open actors of each
+ * side wait on the scene placed next to it unless they are on it. It orders and prunes the children
+ * of every search mode
+ */
+unsigned long astar_estimate(const Solution &solution);
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include "instance.h"
+
+using namespace std;
+
+/**
+ * Main function, converts an instance between the .txt, .dat (MathProg) and .bin formats
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] contains the path of the entry_file, any format, argv[2] the output file, whose
+ * extension gives its format
+ * @return 0 in case of success
+ */
+int main(int argc, const char *argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <entrada.txt|.dat|.bin> <saida.txt|.dat|.bin>" << endl;
+        exit(1);
+    }
+    Instance instance;
+    if (!load_instance(argv[1], instance)) {
+        cerr << "Não foi possível abrir o arquivo de entrada " << argv[1] << endl;
+        exit(1);
+    }
+    if (!save_instance(argv[2], instance)) {
+        cerr << "Não foi possível escrever o arquivo de saída " << argv[2] << endl;
+        exit(1);
+    }
+    // hash of the instance, the same for its three formats
+    printf("%016llx\n", instance.hash);
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <climits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "anytime.h"
+#include "engine.h"
+#include "instance.h"
+#include "timing.h"
+
+using namespace std;
+
+namespace dp {
+
+/**
+ * State of a layer: the set of scenes shot first, the least waiting cost of shooting them and the last
+ * scene of an order reaching that cost, used to rebuild the schedule
+ */
+typedef struct State {
+    unsigned long long scenes;
+    unsigned long cost;
+    int last;
+
+    bool operator<(const State &compareTo) const {
+        if (scenes == compareTo.scenes) {
+            return cost < compareTo.cost;
+        }
+        return scenes < compareTo.scenes;
+    }
+} State;
+
+bool same_scenes(const State &first, const State &second) {
+    return first.scenes == second.scenes;
+}
+
+bool cheaper(const State &first, const State &second) {
+    return first.cost < second.cost;
+}
+
+/**
+ * Data shared by the threads expanding a layer
+ */
+typedef struct Search {
+    const Instance *instance;
+    unsigned long long all_scenes;
+    unsigned long upper_bound;
+    double deadline;
+    const vector<State> *layer;
+    size_t max_children;
+    atomic<size_t> next_chunk;
+    atomic<size_t> children_num;
+    atomic<bool> stopped;
+} Search;
+
+/**
+ * States of a layer expanded by a thread at a time
+ */
+const size_t chunk_size = 256;
+
+/**
+ * Actors that have a scene among scenes and another among the remaining ones, the actors on location
+ * between them
+ */
+void open_actors(const Search &search, unsigned long long scenes, vector<unsigned long long> &open) {
+    const Instance &instance = *search.instance;
+    vector<unsigned long long> remaining(instance.actors_words, 0);
+    open.assign(instance.actors_words, 0);
+    for (unsigned long j = 0; j < instance.days_num; ++j) {
+        vector<unsigned long long> &actors = (scenes >> j) & 1 ? open : remaining;
+        const unsigned long long *row = instance.scene_row(j);
+        for (unsigned long w = 0; w < instance.actors_words; ++w) {
+            actors[w] |= row[w];
+        }
+    }
+    for (unsigned long w = 0; w < instance.actors_words; ++w) {
+        open[w] &= remaining[w];
+    }
+}
+
+/**
+ * Waiting cost of shooting the scene next, the open actors that are not on it
+ */
+unsigned long waiting_cost(const Instance &instance, const vector<unsigned long long> &open, int scene) {
+    const unsigned long long *row = instance.scene_row(scene);
+    unsigned long cost = 0;
+    for (unsigned long w = 0; w < instance.actors_words; ++w) {
+        unsigned long long bits = open[w] & ~row[w];
+        while (bits) {
+            cost += instance.actors_cost[w * 64 + __builtin_ctzll(bits)];
+            bits &= bits - 1;
+        }
+    }
+    return cost;
+}
+
+/**
+ * Lower bound of the cost of the remaining scenes, the cheapest next one
+ */
+unsigned long next_bound(const Search &search, const vector<unsigned long long> &open, unsigned long long scenes) {
+    unsigned long bound = ULONG_MAX;
+    for (unsigned long long remaining = search.all_scenes & ~scenes; remaining; remaining &= remaining - 1) {
+        bound = min(bound, waiting_cost(*search.instance, open, __builtin_ctzll(remaining)));
+    }
+    return bound == ULONG_MAX ? 0 : bound;
+}
+
+/**
+ * Expands chunks of the layer into children until the layer is over, states and children that
+ * reach the upper bound are pruned. Stops the search once the layer has too many children
+ */
+void expand_layer(Search &search, vector<State> &children) {
+    vector<unsigned long long> open;
+    const vector<State> &layer = *search.layer;
+    size_t first;
+    while ((first = search.next_chunk.fetch_add(chunk_size)) < layer.size()) {
+        if (engine_stop(search.deadline)) {
+            search.stopped = true;
+            return;
+        }
+        size_t chunk_start = children.size();
+        for (size_t k = first; k < min(first + chunk_size, layer.size()); ++k) {
+            const State &state = layer[k];
+            open_actors(search, state.scenes, open);
+            if (state.cost + next_bound(search, open, state.scenes) >= search.upper_bound) continue;
+            for (unsigned long long remaining = search.all_scenes & ~state.scenes; remaining;
+                 remaining &= remaining - 1) {
+                State child;
+                child.last = __builtin_ctzll(remaining);
+                child.scenes = state.scenes | (1ULL << child.last);
+                child.cost = state.cost + waiting_cost(*search.instance, open, child.last);
+                if (child.cost < search.upper_bound) children.push_back(child);
+            }
+        }
+        if ((search.children_num += children.size() - chunk_start) > search.max_children) {
+            search.stopped = true;
+            return;
+        }
+    }
+}
+
+/**
+ * Scene order of the state, following the last scenes back through the layers
+ */
+vector<int> rebuild_order(const vector<vector<State> > &layers, State state) {
+    vector<int> order(layers.size() - 1);
+    for (int depth = (int) layers.size() - 1; depth > 0; --depth) {
+        order[depth - 1] = state.last;
+        State previous;
+        previous.scenes = state.scenes & ~(1ULL << state.last);
+        previous.cost = 0;
+        state = *lower_bound(layers[depth - 1].begin(), layers[depth - 1].end(), previous);
+    }
+    return order;
+}
+
+/**
+ * Completes the order shooting at each step the scene with the least waiting cost
+ */
+unsigned long complete_greedy(const Search &search, vector<int> &order, unsigned long long scenes,
+                              unsigned long cost) {
+    vector<unsigned long long> open;
+    while (scenes != search.all_scenes) {
+        open_actors(search, scenes, open);
+        int best_scene = -1;
+        unsigned long best_cost = ULONG_MAX;
+        for (unsigned long long remaining = search.all_scenes & ~scenes; remaining; remaining &= remaining - 1) {
+            int scene = __builtin_ctzll(remaining);
+            unsigned long scene_cost = waiting_cost(*search.instance, open, scene);
+            if (scene_cost < best_cost) {
+                best_scene = scene;
+                best_cost = scene_cost;
+            }
+        }
+        order.push_back(best_scene);
+        scenes |= 1ULL << best_scene;
+        cost += best_cost;
+    }
+    return cost;
+}
+
+}
+
+using namespace dp;
+
+bool run_dp(const Instance &instance, const vector<string> &args, double deadline, EngineResult &result) {
+    reset_result(result);
+    double start_time = wall_seconds();
+    if (instance.days_num > 64) {
+        cerr << "O dp resolve instâncias de até 64 cenas" << endl;
+        return false;
+    }
+    unsigned int threads_num = max(1u, thread::hardware_concurrency());
+    size_t max_states = 1 << 18;
+    for (int i = 0; i + 1 < args.size(); ++i) {
+        if (args[i] == "--threads") {
+            threads_num = (unsigned int) max(1, atoi(args[i + 1].c_str()));
+        } else if (args[i] == "--max-states") {
+            max_states = (size_t) max(1L, atol(args[i + 1].c_str()));
+        }
+    }
+    Search search;
+    search.instance = &instance;
+    search.all_scenes = instance.days_num == 64 ? ~0ULL : (1ULL << instance.days_num) - 1;
+    search.deadline = deadline;
+    search.stopped = false;
+    // a set of k scenes is generated by up to k states of the layer, the duplicates are merged later
+    search.max_children = 4 * max_states;
+
+    // the greedy order is the first incumbent, it prunes the layers from the start
+    result.cost = complete_greedy(search, result.scene_order, 0, 0);
+    record_improvement(result, wall_seconds() - start_time, "greedy");
+    publish_incumbent(result);
+    search.upper_bound = result.cost;
+
+    // layer k holds the sets of k scenes, sorted by set with a single state per set
+    vector<vector<State> > layers(1, vector<State>(1));
+    layers[0][0].scenes = 0;
+    layers[0][0].cost = 0;
+    layers[0][0].last = -1;
+    vector<vector<State> > buffers(threads_num);
+    while (layers.size() <= instance.days_num) {
+        search.layer = &layers.back();
+        search.next_chunk = 0;
+        search.children_num = 0;
+        vector<thread> workers;
+        for (unsigned int t = 1; t < threads_num; ++t) {
+            workers.push_back(thread(expand_layer, ref(search), ref(buffers[t])));
+        }
+        expand_layer(search, buffers[0]);
+        for (int t = 0; t < workers.size(); ++t) {
+            workers[t].join();
+        }
+        result.nodes += search.layer->size();
+        if (search.stopped) break;
+
+        vector<State> next;
+        for (int t = 0; t < buffers.size(); ++t) {
+            next.insert(next.end(), buffers[t].begin(), buffers[t].end());
+            buffers[t].clear();
+        }
+        sort(next.begin(), next.end());
+        next.erase(unique(next.begin(), next.end(), same_scenes), next.end());
+        if (next.size() > max_states) {
+            search.stopped = true;
+            break;
+        }
+        layers.push_back(vector<State>());
+        layers.back().swap(next);
+        if (layers.back().empty()) break;
+
+        // every order goes through a set of the layer or was pruned by the incumbent
+        const State &best = *min_element(layers.back().begin(), layers.back().end(), cheaper);
+        result.bound = max(result.bound, best.cost);
+        vector<int> order = rebuild_order(layers, best);
+        unsigned long cost = complete_greedy(search, order, best.scenes, best.cost);
+        if (cost < result.cost) {
+            result.scene_order = order;
+            result.cost = cost;
+            const char *source = layers.size() > instance.days_num ? "dp" : "dive";
+            record_improvement(result, wall_seconds() - start_time, source);
+            publish_incumbent(result);
+            search.upper_bound = cost;
+        }
+    }
+    if (!search.stopped) {
+        // the search is complete, the incumbent is optimal
+        result.bound = result.cost;
+        result.optimal = true;
+        publish_incumbent(result);
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#include <climits>
+#include <cstdio>
+#include "anytime.h"
+#include "engine.h"
+#include "timing.h"
+
+void reset_result(EngineResult &result) {
+    result.scene_order.clear();
+    result.cost = ULONG_MAX;
+    result.bound = 0;
+    result.nodes = 0;
+    result.time_to_best = 0;
+    result.optimal = false;
+    result.trajectory.clear();
+}
+
+void record_improvement(EngineResult &result, double time, const char *source) {
+    TrajectoryEvent event;
+    event.time = time;
+    event.cost = result.cost;
+    event.nodes = result.nodes;
+    event.source = source;
+    result.time_to_best = time;
+    result.trajectory.push_back(event);
+}
+
+bool write_trajectory(const char *path, const std::string &instance, const std::string &engine,
+                      const EngineResult &result) {
+    FILE *file = fopen(path, "a");
+    if (file == NULL) return false;
+    if (ftell(file) == 0) fprintf(file, "Instancia;Motor;Tempo;Custo;Nos;Origem\n");
+    for (int k = 0; k < result.trajectory.size(); ++k) {
+        const TrajectoryEvent &event = result.trajectory[k];
+        fprintf(file, "%s;%s;%.6f;%lu;%lu;%s\n", instance.c_str(), engine.c_str(), event.time, event.cost,
+                event.nodes, event.source);
+    }
+    return fclose(file) == 0;
+}
+
+bool engine_stop(double deadline) {
+    return should_stop || (deadline > 0 && wall_seconds() >= deadline);
+}
@@ -0,0 +1,77 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <string>
+#include <vector>
+#include "instance.h"
+
+/**
+ * Improvement of the incumbent: seconds since the start of the run, cost, nodes (iterations) so far
+ * and the part of the engine that found it
+ */
+typedef struct TrajectoryEvent {
+    double time;
+    unsigned long cost;
+    unsigned long nodes;
+    const char *source;
+} TrajectoryEvent;
+
+/**
+ * Incumbent and statistics of an engine run, kept up to date during the run so the anytime output
+ * can print it at any moment. The trajectory is kept in memory and only written by write_trajectory
+ */
+typedef struct EngineResult {
+    std::vector<int> scene_order;
+    unsigned long cost;
+    unsigned long bound;
+    unsigned long nodes;
+    double time_to_best;
+    bool optimal;
+    std::vector<TrajectoryEvent> trajectory;
+} EngineResult;
+
+void reset_result(EngineResult &result);
+
+/**
+ * Records the improvement to result.cost found time seconds after the start of the run
+ */
+void record_improvement(EngineResult &result, double time, const char *source);
+
+/**
+ * Appends the trajectory to a CSV file: Instancia;Motor;Tempo;Custo;Nos;Origem, the header is written
+ * if the file is empty
+ * @return false if the file could not be written
+ */
+bool write_trajectory(const char *path, const std::string &instance, const std::string &engine,
+                      const EngineResult &result);
+
+/**
+ * True once SIGINT was received or the wall clock deadline (0 for none) has passed
+ */
+bool engine_stop(double deadline);
+
+/**
+ * Engines, re-entrant so several instances can be solved in parallel threads. args are the command
+ * line options after the instance path
+ * @return false if an option could not be applied, the error was written on cerr
+ */
+bool run_bnb(const Instance &instance, const std::vector<std::string> &args, double deadline,
+             EngineResult &result);
+
+bool run_heur(const Instance &instance, const std::vector<std::string> &args, double deadline,
+              EngineResult &result);
+
+/**
+ * Layered dynamic programming over the sets of scenes shot first, for instances of up to 64 scenes.
+ * Options --threads n (the cores by default) and --max-states n, the largest layer it keeps in memory
+ */
+bool run_dp(const Instance &instance, const std::vector<std::string> &args, double deadline,
+            EngineResult &result);
+
+/**
+ * Writes the operator statistics of the last heur run of this thread on cerr, if --adaptive was given.
+ * On a thread that ran no search it writes the last ones any --adaptive run copied
+ */
+void print_heur_statistics();
+
+#endif
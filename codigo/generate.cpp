@@ -0,0 +1,151 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "instance.h"
+
+using namespace std;
+
+/**
+ * Generator parameters, the actors are split among clusters of scenes and leak a fraction of their
+ * scenes outside of their own cluster. The scenes are shuffled so the clusters are not contiguous
+ */
+unsigned long scenes_num = 100;
+unsigned long actors_num = 20;
+double density = 0.3;
+unsigned long clusters = 1;
+double leak = 0.1;
+const char *cost_distribution = "uniform";
+unsigned long min_cost = 1;
+unsigned long max_cost = 100;
+unsigned long long seed = 1;
+
+/**
+ * splitmix64, the same seed gives the same instance on any platform
+ */
+unsigned long long next_random() {
+    unsigned long long z = (seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Uniform in [0, 1)
+ */
+double next_double() {
+    return (next_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+unsigned long next_below(unsigned long bound) {
+    return (unsigned long) (next_random() % bound);
+}
+
+/**
+ * Cost of an actor: uniform in [min_cost, max_cost], constant min_cost or pareto (alpha 1.5) starting
+ * at min_cost and capped at max_cost
+ */
+unsigned long next_cost() {
+    if (strcmp(cost_distribution, "constant") == 0) return min_cost;
+    if (strcmp(cost_distribution, "pareto") == 0) {
+        double cost = min_cost * pow(1 - next_double(), -1 / 1.5);
+        return cost > max_cost ? max_cost : (unsigned long) cost;
+    }
+    return min_cost + next_below(max_cost - min_cost + 1);
+}
+
+void generate(Instance &instance) {
+    resize_instance(instance, scenes_num, actors_num);
+    // cluster of each scene position, then the positions are shuffled into scene labels
+    vector<unsigned long> scene_cluster(scenes_num);
+    for (unsigned long j = 0; j < scenes_num; ++j) {
+        scene_cluster[j] = j * clusters / scenes_num;
+    }
+    for (unsigned long j = scenes_num - 1; j > 0; --j) {
+        swap(scene_cluster[j], scene_cluster[next_below(j + 1)]);
+    }
+    double expected_scenes = density * scenes_num;
+    double cluster_size = (double) scenes_num / clusters;
+    double inside = clusters == 1 ? density : min(1.0, expected_scenes * (1 - leak) / cluster_size);
+    double outside = clusters == 1 ? density : min(1.0, expected_scenes * leak / (scenes_num - cluster_size));
+    for (unsigned long i = 0; i < actors_num; ++i) {
+        unsigned long cluster = next_below(clusters);
+        unsigned long long *row = &instance.actors_scenes[i * instance.words];
+        bool on_any = false;
+        for (unsigned long j = 0; j < scenes_num; ++j) {
+            if (next_double() < (scene_cluster[j] == cluster ? inside : outside)) {
+                row[j / 64] |= 1ULL << (j % 64);
+                on_any = true;
+            }
+        }
+        // every actor is on at least one scene of its cluster
+        while (!on_any) {
+            unsigned long j = next_below(scenes_num);
+            if (scene_cluster[j] == cluster) {
+                row[j / 64] |= 1ULL << (j % 64);
+                on_any = true;
+            }
+        }
+        instance.actors_cost[i] = next_cost();
+    }
+    index_instance(instance);
+}
+
+/**
+ * Main function, writes a random instance
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] contains the output file, .txt, .dat or .bin, argv[2..] optional parameters:
+ *             --scenes n, --actors m, --density p, --clusters k, --leak q,
+ *             --costs uniform|constant|pareto, --min-cost a, --max-cost b, --seed s
+ * @return 0 in case of success
+ */
+int main(int argc, const char *argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " <saida.txt|.dat|.bin> [--scenes n] [--actors m] [--density p]"
+             << " [--clusters k] [--leak q] [--costs uniform|constant|pareto] [--min-cost a] [--max-cost b]"
+             << " [--seed s]" << endl;
+        exit(1);
+    }
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--scenes") == 0) {
+            scenes_num = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--actors") == 0) {
+            actors_num = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--density") == 0) {
+            density = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--clusters") == 0) {
+            clusters = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--leak") == 0) {
+            leak = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--costs") == 0) {
+            cost_distribution = argv[i + 1];
+        } else if (strcmp(argv[i], "--min-cost") == 0) {
+            min_cost = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--max-cost") == 0) {
+            max_cost = strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = strtoull(argv[i + 1], NULL, 10);
+        } else {
+            cerr << "Parâmetro desconhecido " << argv[i] << endl;
+            exit(1);
+        }
+    }
+    if (scenes_num == 0 || actors_num == 0 || clusters == 0 || clusters > scenes_num || density <= 0 ||
+        density > 1 || leak < 0 || leak > 1 || min_cost > max_cost ||
+        (strcmp(cost_distribution, "uniform") != 0 && strcmp(cost_distribution, "constant") != 0 &&
+         strcmp(cost_distribution, "pareto") != 0)) {
+        cerr << "Parâmetros inválidos" << endl;
+        exit(1);
+    }
+    Instance instance;
+    generate(instance);
+    if (!save_instance(argv[1], instance)) {
+        cerr << "Não foi possível escrever o arquivo de saída " << argv[1] << endl;
+        exit(1);
+    }
+    printf("%016llx\n", instance.hash);
+    return 0;
+}
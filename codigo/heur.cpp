@@ -1,76 +1,158 @@
 #include <iostream>
 #include <cstdlib>
 #include <vector>
-#include <csignal>
 #include <queue>
-#include <fstream>
 #include <climits>
 #include <algorithm>
 #include <numeric>
+#include <cstring>
+#include <cmath>
+#include <mutex>
+#include "anytime.h"
+#include "engine.h"
+#include "heur.h"
+#include "incumbent_channel.h"
+#include "instance.h"
+#include "schedule.h"
+#include "timing.h"
 
 using namespace std;
 
+namespace heur {
+
 /**
- * Actor data definition
+ * Mutation operator and its statistics, the mutation returns the first position it changed. The
+ * reward of a batch is its gain per CPU microsecond over the best rate of any batch so far
  */
-typedef struct Actor {
-    int start;
-    int filmed_scenes;
-    bool complete;
-} Actor;
+typedef struct Operator {
+    const char *name;
+    int (*mutate)(Solution &chromosome);
+    unsigned long uses;
+    unsigned long improvements;
+    unsigned long gain;
+    double time;
+    unsigned long batches;
+    double reward;
+} Operator;
 
 /**
- * ActorLkup data definition
+ * Sets min/max initial cost and solves the problem, the state is per thread so runs can be parallel
  */
-typedef struct ActorLkup {
-    int total_scenes;
-    unsigned long cost;
-} ActorLkup;
+thread_local unsigned long days_num_lkup;
+thread_local const Instance *instance_lkup;
+thread_local vector<int> scenes_sample;
+thread_local vector<ActorLkup> actors_lkup;
+thread_local vector<Solution> solutions;
+thread_local vector<Actor> actors_sample;
+unsigned int  pop_size = 1000;
+unsigned int block_size = 100;
+thread_local unsigned int without_change;
+unsigned int without_change_limit = 1000000;
+thread_local int checkpoint_interval;
+thread_local double deadline;
+thread_local double start_time;
+thread_local EngineResult *result;
+thread_local unsigned long long random_state;
 
 /**
- * OrderedScene by cost desc
+ * Large neighborhood search: a window of lns_window consecutive positions of the best
+ * chromosome is reordered exactly while everything outside of it stays fixed
  */
-typedef struct OrderedScene {
-    int scene;
-    unsigned long cost;
+thread_local bool lns_enabled;
+unsigned int lns_interval = 1000;
+unsigned int lns_window_initial = 8;
+unsigned int lns_window_min = 4;
+unsigned int lns_window_max = 20;
+thread_local unsigned int lns_window;
+thread_local unsigned int lns_offset;
+double lns_target_time = 0.05;
 
-    bool operator<(const OrderedScene &compareTo) const {
-        return cost < compareTo.cost;
-    }
-} OrderedScene;
 /**
- * A solution
+ * Path relinking between elite chromosomes, every relinking_interval iterations
  */
-typedef struct Solution {
-    vector<int> scenes;
-    unsigned long cost;
-    bool operator<(const Solution &compareTo) const {
-        return cost < compareTo.cost;
-    };
-} Solution;
+thread_local bool relinking_enabled;
+unsigned int relinking_interval = 5000;
+unsigned int relinking_candidates = 10;
 
 /**
- * Sets min/max initial cost and solves the problem
+ * Adaptive operator selection, UCB1 over the improvement per CPU microsecond of each operator, scaled
+ * to [0, 1] by the running maximum of that rate. An operator is picked
+ * and timed for a batch of operator_batch iterations, which divides the intervals of the LNS, the path
+ * relinking and the channel so their work starts before the timing of a batch
  */
-unsigned long days_num_lkup;
-vector<vector<int> > actors_scenes_lkup;
-vector<int> scenes_sample;
-vector<ActorLkup> actors_lkup;
-vector<Solution> solutions;
-vector<Actor> actors_sample;
-bool best_solution_updating = false;
-bool should_stop = false;
-unsigned int  pop_size = 1000;
-unsigned int block_size = 100;
-unsigned int without_change = 0;
-unsigned int without_change_limit = 1000000;
+thread_local bool adaptive_enabled;
+double exploration_rate = sqrt(2.0);
+unsigned int operator_batch = 50;
+thread_local vector<Operator> operators;
+
+/**
+ * Copy of the operator statistics of the last batch closed by any thread, printed by a thread that
+ * did not run the search, as the anytime watcher
+ */
+mutex operators_mutex;
+vector<Operator> operators_snapshot;
+
+/**
+ * Incumbent shared with the other engines of a portfolio run, synchronized every channel_interval
+ * iterations, NULL when running alone
+ */
+thread_local IncumbentChannel *channel;
+unsigned int channel_interval = 1000;
+
+/**
+ * xorshift64*, a generator per thread instead of rand() so parallel runs are reproducible
+ */
+unsigned int next_random() {
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return (unsigned int) ((random_state * 2685821657736338717ULL) >> 33);
+}
+
+long random_below(long bound) {
+    return next_random() % bound;
+}
+
+/**
+ * Inserts the chromosome into the population in place of the worst one, keeping the result up to
+ * date when it is the new best
+ */
+void insert_solution(const Solution &chromosome, const char *source) {
+    bool best = chromosome.cost < solutions[0].cost;
+    solutions.pop_back();
+    solutions.insert(std::upper_bound(solutions.begin(), solutions.end(), chromosome), chromosome);
+    if (best) {
+        result->scene_order = chromosome.scenes;
+        result->cost = chromosome.cost;
+        record_improvement(*result, wall_seconds() - start_time, source);
+        publish_incumbent(*result);
+    }
+}
 
-unsigned long calculate_cost(vector<int> &scene_order) {
+bool evaluate(Solution &chromosome, int first_changed, unsigned long cutoff, bool record) {
+    vector<int> &scene_order = chromosome.scenes;
+    unsigned long actors_num = actors_sample.size();
+    if (record && chromosome.checkpoint_costs.empty()) {
+        chromosome.checkpoints = actors_sample;
+        chromosome.checkpoint_costs.assign(1, 0);
+    }
+    int checkpoint = 0;
     vector<Actor> actors = actors_sample;
     unsigned long cost = 0;
-    for (int j = 0; j < scene_order.size(); ++j) {
-        for (int k =0; k < actors_sample.size(); ++k) {
-            if (actors_scenes_lkup[k][scene_order[j]]) {
+    if (!chromosome.checkpoint_costs.empty()) {
+        checkpoint = min(first_changed / checkpoint_interval, (int) chromosome.checkpoint_costs.size() - 1);
+        chromosome.checkpoints.resize((checkpoint + 1) * actors_num);
+        chromosome.checkpoint_costs.resize(checkpoint + 1);
+        actors.assign(chromosome.checkpoints.end() - actors_num, chromosome.checkpoints.end());
+        cost = chromosome.checkpoint_costs.back();
+    }
+    for (int j = checkpoint * checkpoint_interval; j < scene_order.size(); ++j) {
+        if (record && j % checkpoint_interval == 0 && j / checkpoint_interval == chromosome.checkpoint_costs.size()) {
+            chromosome.checkpoints.insert(chromosome.checkpoints.end(), actors.begin(), actors.end());
+            chromosome.checkpoint_costs.push_back(cost);
+        }
+        for (int k = 0; k < actors_num; ++k) {
+            if (instance_lkup->on_scene(k, scene_order[j])) {
                 actors[k].filmed_scenes++;
                 if (actors[k].start == -1) {
                     actors[k].start = scene_order[j];
@@ -82,15 +164,20 @@ unsigned long calculate_cost(vector<int> &scene_order) {
                 cost += actors_lkup[k].cost;
             }
         }
+        if (cost >= cutoff) {
+            chromosome.cost = ULONG_MAX;
+            return false;
+        }
     }
-    return cost;
+    chromosome.cost = cost;
+    return true;
 }
 
 Solution generate_random_solution() {
     Solution random_solution;
     random_solution.scenes = scenes_sample;
-    random_shuffle(random_solution.scenes.begin(),random_solution.scenes.end());
-    random_solution.cost = calculate_cost(random_solution.scenes);
+    random_shuffle(random_solution.scenes.begin(), random_solution.scenes.end(), random_below);
+    evaluate(random_solution, 0);
     return random_solution;
 }
 
@@ -101,10 +188,10 @@ void generate_random_solutions() {
     }
 }
 
-void init_data(unsigned long days_num, unsigned long actors_num, vector<vector<int> > actors_scenes,
-               vector<unsigned long> actors_cost) {
+void init_data(const Instance &instance) {
+    unsigned long days_num = instance.days_num, actors_num = instance.actors_num;
+    instance_lkup = &instance;
     days_num_lkup = days_num;
-    actors_scenes_lkup = actors_scenes;
     scenes_sample.resize(days_num);
     for(int i = 0; i < days_num; i++) {
         scenes_sample[i] = i;
@@ -115,114 +202,440 @@ void init_data(unsigned long days_num, unsigned long actors_num, vector<vector<i
         actors_sample[k].filmed_scenes = 0;
         actors_sample[k].complete = false;
     }
-    for (int i = 0; i < actors_num; ++i) {
-        ActorLkup actor_lkup;
-        actor_lkup.cost = actors_cost[i];
-        actor_lkup.total_scenes = 0;
-        for (int j = 0; j < days_num; ++j) {
-            if (actors_scenes_lkup[i][j]) actor_lkup.total_scenes++;
-        }
-        actors_lkup.push_back(actor_lkup);
+    checkpoint_interval = 1;
+    while ((checkpoint_interval + 1) * (checkpoint_interval + 1) <= days_num) {
+        checkpoint_interval++;
     }
+    actors_lkup = build_actors_lkup(instance);
+}
+
+void init_population() {
+    solutions.clear();
     generate_random_solutions();
+    result->scene_order = solutions[0].scenes;
+    result->cost = solutions[0].cost;
+    record_improvement(*result, wall_seconds() - start_time, "random");
+    publish_incumbent(*result);
 }
 
-void print_formatted_result() {
-    cout << endl;
-    for (int l = 0; l < solutions[0].scenes.size(); ++l) {
-        cout << solutions[0].scenes[l] << " ";
+void print_operators_statistics(const vector<Operator> &operators) {
+    cerr << "operator uses improvements gain time(us) gain/us" << endl;
+    for (int i = 0; i < operators.size(); ++i) {
+        cerr << operators[i].name << " " << operators[i].uses << " " << operators[i].improvements << " "
+             << operators[i].gain << " " << (unsigned long) operators[i].time << " "
+             << (operators[i].time > 0 ? operators[i].gain / operators[i].time : 0) << endl;
     }
-    cout << endl << solutions[0].cost << endl;
 }
 
 unsigned int adaptative_proportional_position() {
     int block_number = pop_size / block_size;
     int block_probability = 100/block_number;
-    unsigned int position = rand() % block_size;
+    unsigned int position = next_random() % block_size;
     for(int i = 0; i < block_number - 1; i++) {
-        position += (rand() % 100 < block_probability) ? block_size : 0;
+        position += (next_random() % 100 < block_probability) ? block_size : 0;
     }
     return position;
 }
 
+/**
+ * Reorders scene_order[first, first + size) optimally with a subset DP, the scenes before and
+ * after the window stay fixed. The cost of a day inside the window only depends on the set of
+ * scenes already shot, so dp[S] is the min cost to shoot the window scenes in S first
+ * @return true if the window order was changed
+ */
+bool solve_window(vector<int> &scene_order, int first, int size) {
+    unsigned long words = instance_lkup->actors_words;
+    unsigned int states = 1U << size;
+    // actors with scenes before and after the window
+    vector<unsigned long long> prefix_mask(words, 0), suffix_mask(words, 0);
+    for (int j = 0; j < first; ++j) {
+        for (int w = 0; w < words; ++w) prefix_mask[w] |= instance_lkup->scene_row(scene_order[j])[w];
+    }
+    for (int j = first + size; j < scene_order.size(); ++j) {
+        for (int w = 0; w < words; ++w) suffix_mask[w] |= instance_lkup->scene_row(scene_order[j])[w];
+    }
+    // actors of each subset of the window scenes
+    vector<unsigned long long> subset_mask(states * words, 0);
+    for (unsigned int S = 1; S < states; ++S) {
+        int low = __builtin_ctz(S);
+        const unsigned long long *scene_mask = instance_lkup->scene_row(scene_order[first + low]);
+        for (int w = 0; w < words; ++w) {
+            subset_mask[S * words + w] = subset_mask[(S & (S - 1)) * words + w] | scene_mask[w];
+        }
+    }
+    vector<unsigned long> dp(states, ULONG_MAX);
+    vector<unsigned char> last_scene(states, 0);
+    vector<unsigned long long> waiting(words);
+    dp[0] = 0;
+    for (unsigned int S = 0; S < states - 1; ++S) {
+        if (dp[S] == ULONG_MAX) continue;
+        for (int i = 0; i < size; ++i) {
+            if (S & (1U << i)) continue;
+            unsigned int next = S | (1U << i);
+            unsigned int rest = (states - 1) & ~next;
+            const unsigned long long *scene_mask = instance_lkup->scene_row(scene_order[first + i]);
+            // waiting actors: already started, not finished and not on this scene
+            for (int w = 0; w < words; ++w) {
+                waiting[w] = (prefix_mask[w] | subset_mask[S * words + w]) &
+                             (suffix_mask[w] | subset_mask[rest * words + w]) & ~scene_mask[w];
+            }
+            unsigned long cost = dp[S] + actors_mask_cost(*instance_lkup, &waiting[0]);
+            if (cost < dp[next]) {
+                dp[next] = cost;
+                last_scene[next] = (unsigned char) i;
+            }
+        }
+    }
+    vector<int> window(size);
+    unsigned int S = states - 1;
+    for (int position = size - 1; position >= 0; --position) {
+        window[position] = scene_order[first + last_scene[S]];
+        S &= ~(1U << last_scene[S]);
+    }
+    if (equal(window.begin(), window.end(), scene_order.begin() + first)) return false;
+    copy(window.begin(), window.end(), scene_order.begin() + first);
+    return true;
+}
+
+/**
+ * Solves the current window of the best chromosome exactly, rotates the window and adapts its
+ * size to keep each window solve close to lns_target_time
+ */
+void large_neighborhood_search() {
+    int size = (int) min((unsigned long) lns_window, days_num_lkup);
+    // the last window ends on the last position, the next one starts over
+    if (lns_offset + size > days_num_lkup) {
+        lns_offset = (unsigned int) (days_num_lkup - size);
+    }
+    int first = lns_offset;
+    Solution chromosome = solutions[0];
+    double start = cpu_seconds();
+    bool changed = solve_window(chromosome.scenes, lns_offset, size);
+    double elapsed = cpu_seconds() - start;
+    if (elapsed < lns_target_time / 4 && lns_window < lns_window_max) {
+        lns_window++;
+    } else if (elapsed > lns_target_time && lns_window > lns_window_min) {
+        lns_window--;
+    }
+    lns_offset = first + size >= days_num_lkup ? 0 : first + max(1, size / 2);
+    if (!changed) return;
+    if (evaluate(chromosome, first, solutions[0].cost)) {
+        without_change = 0;
+        insert_solution(chromosome, "lns");
+    }
+}
+
+/**
+ * Number of positions where the two chromosomes have different scenes
+ */
+int hamming_distance(const Solution &first, const Solution &second) {
+    int distance = 0;
+    for (int j = 0; j < first.scenes.size(); ++j) {
+        if (first.scenes[j] != second.scenes[j]) distance++;
+    }
+    return distance;
+}
+
+/**
+ * Walks from origin towards guide fixing one position at a time, each intermediate chromosome
+ * only changes from its first fixed position on, so it is evaluated from the checkpoints
+ * @return the best intermediate chromosome, with cost ULONG_MAX if none beat the cutoff
+ */
+Solution relink(const Solution &origin, const Solution &guide, unsigned long cutoff) {
+    Solution current = origin, best;
+    best.cost = ULONG_MAX;
+    vector<int> position(days_num_lkup);
+    for (int j = 0; j < days_num_lkup; ++j) {
+        position[current.scenes[j]] = j;
+    }
+    // the last fix would turn current into guide, so it stops one position before
+    int remaining = hamming_distance(origin, guide);
+    for (int j = 0; j < days_num_lkup && remaining > 2; ++j) {
+        if (current.scenes[j] == guide.scenes[j]) continue;
+        int swap_position = position[guide.scenes[j]];
+        position[current.scenes[j]] = swap_position;
+        position[guide.scenes[j]] = j;
+        swap(current.scenes[j], current.scenes[swap_position]);
+        remaining -= (current.scenes[swap_position] == guide.scenes[swap_position]) ? 2 : 1;
+        if (evaluate(current, j, min(cutoff, best.cost), true)) {
+            best = current;
+        }
+    }
+    return best;
+}
+
+/**
+ * Relinks an elite chromosome with the most distant of a few other elite chromosomes and inserts
+ * the best intermediate one into the population
+ */
+void path_relinking() {
+    const Solution &origin = solutions[next_random() % block_size];
+    int guide_position = -1, guide_distance = 0;
+    for (int i = 0; i < relinking_candidates; ++i) {
+        int candidate = next_random() % block_size;
+        int distance = hamming_distance(origin, solutions[candidate]);
+        if (distance > guide_distance) {
+            guide_position = candidate;
+            guide_distance = distance;
+        }
+    }
+    if (guide_position == -1) return;
+    Solution chromosome = relink(origin, solutions[guide_position], solutions.back().cost);
+    if (chromosome.cost == ULONG_MAX) return;
+    if (chromosome.cost < solutions[0].cost) {
+        without_change = 0;
+    }
+    insert_solution(chromosome, "relinking");
+}
+
+int swap_mutation(Solution &chromosome) {
+    int mutation_size = (int) (((next_random() % (days_num_lkup / 2))));
+    int first_changed = (int) days_num_lkup;
+    for (int i = 0; i < mutation_size; i++) {
+        int new_position = (int) (next_random() % days_num_lkup);
+        if (new_position != i) {
+            first_changed = min(first_changed, min(i, new_position));
+        }
+        int scene_on_change = chromosome.scenes[i];
+        chromosome.scenes[i] = chromosome.scenes[new_position];
+        chromosome.scenes[new_position] = scene_on_change;
+    }
+    return first_changed;
+}
+
+int insertion_mutation(Solution &chromosome) {
+    int from = (int) (next_random() % days_num_lkup), to = (int) (next_random() % days_num_lkup);
+    int scene = chromosome.scenes[from];
+    chromosome.scenes.erase(chromosome.scenes.begin() + from);
+    chromosome.scenes.insert(chromosome.scenes.begin() + to, scene);
+    return min(from, to);
+}
+
+int block_move_mutation(Solution &chromosome) {
+    int length = 1 + (int) (next_random() % max(1UL, days_num_lkup / 4));
+    int from = (int) (next_random() % (days_num_lkup - length + 1)), to = (int) (next_random() % (days_num_lkup - length + 1));
+    vector<int> block(chromosome.scenes.begin() + from, chromosome.scenes.begin() + from + length);
+    chromosome.scenes.erase(chromosome.scenes.begin() + from, chromosome.scenes.begin() + from + length);
+    chromosome.scenes.insert(chromosome.scenes.begin() + to, block.begin(), block.end());
+    return min(from, to);
+}
+
+int reversal_mutation(Solution &chromosome) {
+    int first = (int) (next_random() % days_num_lkup), last = (int) (next_random() % days_num_lkup);
+    if (first > last) swap(first, last);
+    reverse(chromosome.scenes.begin() + first, chromosome.scenes.begin() + last + 1);
+    return first;
+}
+
+/**
+ * Keeps the scenes before a random cut and fills the rest in the order of another elite chromosome
+ */
+int crossover_mutation(Solution &chromosome) {
+    const vector<int> &other = solutions[next_random() % block_size].scenes;
+    int cut = (int) (next_random() % days_num_lkup);
+    vector<bool> used(days_num_lkup, false);
+    for (int j = 0; j < cut; ++j) {
+        used[chromosome.scenes[j]] = true;
+    }
+    int position = cut;
+    for (int j = 0; j < days_num_lkup; ++j) {
+        if (!used[other[j]]) chromosome.scenes[position++] = other[j];
+    }
+    return cut;
+}
+
+void register_operator(const char *name, int (*mutate)(Solution &chromosome)) {
+    Operator mutation_operator;
+    mutation_operator.name = name;
+    mutation_operator.mutate = mutate;
+    mutation_operator.uses = mutation_operator.improvements = mutation_operator.gain = 0;
+    mutation_operator.time = 0;
+    mutation_operator.batches = 0;
+    mutation_operator.reward = 0;
+    operators.push_back(mutation_operator);
+}
+
+void register_operators() {
+    operators.clear();
+    register_operator("swap", swap_mutation);
+    register_operator("insertion", insertion_mutation);
+    register_operator("block_move", block_move_mutation);
+    register_operator("reversal", reversal_mutation);
+    register_operator("crossover", crossover_mutation);
+}
+
+/**
+ * Picks the operator of the next batch with the best upper confidence bound on its mean reward, the
+ * swap mutation is always used if adaptive selection is disabled
+ */
+int select_operator(unsigned long batches) {
+    if (!adaptive_enabled) return 0;
+    for (int i = 0; i < operators.size(); ++i) {
+        if (operators[i].batches == 0) return i;
+    }
+    int selected = 0;
+    double selected_score = -1;
+    for (int i = 0; i < operators.size(); ++i) {
+        double score = operators[i].reward / operators[i].batches +
+                       exploration_rate * sqrt(log((double) batches) / operators[i].batches);
+        if (score > selected_score) {
+            selected = i;
+            selected_score = score;
+        }
+    }
+    return selected;
+}
+
+/**
+ * Publishes the best chromosome and brings in a better incumbent found by another engine
+ */
+void sync_channel() {
+    channel_publish(channel, solutions[0].cost, &solutions[0].scenes[0], (int) days_num_lkup, "heur");
+    if (channel_cost(channel) >= solutions[0].cost) return;
+    Solution chromosome;
+    int scenes_num;
+    chromosome.scenes.resize(CHANNEL_MAX_SCENES);
+    channel_read(channel, &chromosome.scenes[0], &scenes_num, NULL);
+    if (scenes_num != days_num_lkup) return;
+    chromosome.scenes.resize(scenes_num);
+    evaluate(chromosome, 0);
+    without_change = 0;
+    insert_solution(chromosome, "shared");
+}
+
 void solve() {
+    unsigned long iteration = 0;
+    // operator of the current batch, its mutations so far and their gain, best gain per us of a batch
+    int selected = 0;
+    unsigned long batches = 0, batch_uses = 0, batch_gain = 0;
+    double batch_start = 0, max_rate = 0;
     while (without_change < without_change_limit) {
+        iteration++;
+        result->nodes = iteration;
+        if (lns_enabled && iteration % lns_interval == 0) {
+            large_neighborhood_search();
+            if (engine_stop(deadline)) {
+                break;
+            }
+        }
+        if (relinking_enabled && iteration % relinking_interval == 0) {
+            path_relinking();
+            if (engine_stop(deadline)) {
+                break;
+            }
+        }
+        if (channel != NULL && iteration % channel_interval == 0) {
+            sync_channel();
+        }
         int position = adaptative_proportional_position();
-        Solution chromosome = solutions[position];
-        int mutation_size = (int) (((rand() % (days_num_lkup / 2))));
-        for (int i = 0; i < mutation_size; i++) {
-            int new_position = (int) (rand() % days_num_lkup);
-            int scene_on_change = chromosome.scenes[i];
-            chromosome.scenes[i] = chromosome.scenes[new_position];
-            chromosome.scenes[new_position] = scene_on_change;
-        }
-        chromosome.cost = calculate_cost(chromosome.scenes);
+        Solution chromosome;
+        chromosome.scenes = solutions[position].scenes;
+        if (batch_uses == 0) {
+            selected = select_operator(batches);
+            batch_start = cpu_seconds();
+        }
+        Operator &mutation_operator = operators[selected];
+        int first_changed = mutation_operator.mutate(chromosome);
+        // a mutant of an elite chromosome resumes from its checkpoints, built the first time they are used
+        if (position < block_size && first_changed >= checkpoint_interval) {
+            Solution &parent = solutions[position];
+            if (parent.checkpoint_costs.empty()) evaluate(parent, 0, ULONG_MAX, true);
+            int checkpoint = min(first_changed / checkpoint_interval, (int) parent.checkpoint_costs.size() - 1);
+            chromosome.checkpoints.assign(parent.checkpoints.begin(),
+                                          parent.checkpoints.begin() + (checkpoint + 1) * actors_sample.size());
+            chromosome.checkpoint_costs.assign(parent.checkpoint_costs.begin(),
+                                               parent.checkpoint_costs.begin() + checkpoint + 1);
+        }
+        // only a chromosome better than the worst one enters the population
+        bool accepted = evaluate(chromosome, first_changed, solutions.back().cost);
+        chromosome.checkpoints.clear();
+        chromosome.checkpoint_costs.clear();
+        mutation_operator.uses++;
+        batch_uses++;
+        if (accepted && chromosome.cost < solutions[position].cost) {
+            mutation_operator.improvements++;
+            mutation_operator.gain += solutions[position].cost - chromosome.cost;
+            batch_gain += solutions[position].cost - chromosome.cost;
+        }
+        if ((iteration + 1) % operator_batch == 0) {
+            double batch_time = max(1e-3, (cpu_seconds() - batch_start) * 1000000);
+            double rate = batch_gain / batch_time;
+            max_rate = max(max_rate, rate);
+            mutation_operator.time += batch_time;
+            mutation_operator.batches++;
+            mutation_operator.reward += max_rate > 0 ? rate / max_rate : 0;
+            batches++;
+            batch_uses = batch_gain = 0;
+            if (adaptive_enabled) {
+                lock_guard<mutex> lock(operators_mutex);
+                operators_snapshot = operators;
+            }
+        }
+        if (!accepted) {
+            without_change++;
+            if (engine_stop(deadline)) {
+                break;
+            }
+            continue;
+        }
         if (chromosome.cost < solutions[0].cost) {
-            best_solution_updating = true;
             without_change = 0;
         } else {
             without_change++;
         }
-        solutions.pop_back();
-        solutions.insert(std::upper_bound(solutions.begin(), solutions.end(), chromosome), chromosome);
-        best_solution_updating = false;
-        if (should_stop) {
+        insert_solution(chromosome, mutation_operator.name);
+        if (engine_stop(deadline)) {
             break;
         }
     }
-    print_formatted_result();
-    exit(0);
 }
 
-void stop_execution(int signum) {
-    should_stop = true;
-    if(!best_solution_updating) {
-        print_formatted_result();
-        exit(0);
-    }
 }
 
+using namespace heur;
 
-/**
- * Main function, organize the algorithm flow
- * @param argc num of arguments on the command line
- * @param argv argv[1] contains the path of the entry_file
- * @return 0 in case of success
- */
-int main(int argc, const char *argv[]) {
-    // register signal
-    signal(SIGINT, stop_execution);
-    // data declaration
-    unsigned long days_num, actors_num;
-
-    // open file on argv[1]
-    ifstream entry_file;
-    entry_file.open(argv[1]);
-    if (!entry_file) {
-        cerr << "Não foi possível abrir o arquivo de entrada " << argv[1];
-        exit(1);
+void print_heur_statistics() {
+    if (adaptive_enabled) {
+        print_operators_statistics(operators);
+        return;
     }
-
-    // read data from file
-    entry_file >> days_num;
-    entry_file >> actors_num;
-
-    // read scenes requirements
-    vector<vector<int> > actors_scenes(actors_num, vector<int>(days_num));
-    for (int actor = 0; actor < actors_num; ++actor) {
-        for (int day = 0; day < days_num; ++day) {
-            entry_file >> actors_scenes[actor][day];
-        }
+    lock_guard<mutex> lock(operators_mutex);
+    if (!operators_snapshot.empty()) {
+        print_operators_statistics(operators_snapshot);
     }
+}
 
-    // read actor cost
-    vector<unsigned long> actors_cost(actors_num);
-    for (int i = 0; i < actors_num; ++i) {
-        entry_file >> actors_cost[i];
+bool run_heur(const Instance &instance, const vector<string> &args, double run_deadline, EngineResult &run_result) {
+    reset_result(run_result);
+    result = &run_result;
+    deadline = run_deadline;
+    start_time = wall_seconds();
+    random_state = 1;
+    without_change = 0;
+    lns_enabled = relinking_enabled = adaptive_enabled = false;
+    lns_window = lns_window_initial;
+    lns_offset = 0;
+    channel = NULL;
+    // optional flags after the entry file
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--lns") {
+            lns_enabled = true;
+        } else if (args[i] == "--relinking") {
+            relinking_enabled = true;
+        } else if (args[i] == "--adaptive") {
+            adaptive_enabled = true;
+        } else if (args[i] == "--shared" && i + 1 < args.size()) {
+            channel = channel_open(args[++i].c_str(), 0);
+        }
     }
     // init solving problem
-    init_data(days_num, actors_num, actors_scenes, actors_cost);
+    init_data(instance);
+    init_population();
+    register_operators();
     solve();
-    print_formatted_result();
-    return 0;
-}
\ No newline at end of file
+    if (channel != NULL) {
+        munmap(channel, sizeof(IncumbentChannel));
+        channel = NULL;
+    }
+    return true;
+}
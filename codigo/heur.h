@@ -0,0 +1,63 @@
+#ifndef HEUR_H
+#define HEUR_H
+
+#include <climits>
+#include <vector>
+#include "instance.h"
+
+/**
+ * Genetic heuristic over scene orders. The search itself is run through run_heur (engine.h), this
+ * exposes the chromosome evaluation to the benchmarks
+ */
+namespace heur {
+
+/**
+ * Actor data definition
+ */
+typedef struct Actor {
+    int start;
+    int filmed_scenes;
+    bool complete;
+} Actor;
+
+/**
+ * OrderedScene by cost desc
+ */
+typedef struct OrderedScene {
+    int scene;
+    unsigned long cost;
+
+    bool operator<(const OrderedScene &compareTo) const {
+        return cost < compareTo.cost;
+    }
+} OrderedScene;
+
+/**
+ * A solution
+ */
+typedef struct Solution {
+    std::vector<int> scenes;
+    unsigned long cost;
+    // actors state and cost before every checkpoint_interval positions, only kept by elite chromosomes
+    std::vector<Actor> checkpoints;
+    std::vector<unsigned long> checkpoint_costs;
+    bool operator<(const Solution &compareTo) const {
+        return cost < compareTo.cost;
+    };
+} Solution;
+
+/**
+ * Loads the lookups of the instance for the calling thread
+ */
+void init_data(const Instance &instance);
+
+/**
+ * Evaluates the chromosome resuming from the last checkpoint before first_changed, if it has any. Its
+ * checkpoints must come from a solution that has the same scenes on the positions before first_changed.
+ * With record the checkpoints past the resumed one are rebuilt on the way
+ * @return false if the partial cost reached the cutoff, the chromosome is rejected with cost ULONG_MAX
+ */
+bool evaluate(Solution &chromosome, int first_changed, unsigned long cutoff = ULONG_MAX, bool record = false);
+}
+
+#endif
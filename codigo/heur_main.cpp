@@ -0,0 +1,58 @@
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <cstring>
+#include "anytime.h"
+#include "engine.h"
+#include "instance.h"
+
+using namespace std;
+
+Instance instance;
+EngineResult result;
+string instance_name;
+/**
+ * File the trajectory of the incumbent is appended to on exit (--trajectory), NULL for none
+ */
+const char *trajectory_path = NULL;
+
+void print_formatted_result(const EngineResult &result) {
+    if (trajectory_path != NULL && !write_trajectory(trajectory_path, instance_name, "heur", result)) {
+        cerr << "Não foi possível escrever a trajetória " << trajectory_path << endl;
+    }
+    print_heur_statistics();
+    cout << endl;
+    for (int l = 0; l < result.scene_order.size(); ++l) {
+        cout << result.scene_order[l] << " ";
+    }
+    cout << endl << result.cost << endl;
+}
+
+/**
+ * Main function, organize the algorithm flow
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] contains the path of the entry_file, argv[2..] optional flags: --lns, --relinking, --adaptive,
+ *             --shared <shm name>, --trajectory <file>
+ * @return 0 in case of success
+ */
+int main(int argc, const char *argv[]) {
+    // register signal
+    reset_result(result);
+    anytime_init(print_formatted_result);
+    // read data from file on argv[1]
+    if (argc < 2 || !load_instance(argv[1], instance)) {
+        cerr << "Não foi possível abrir o arquivo de entrada " << (argc < 2 ? "" : argv[1]);
+        exit(1);
+    }
+    instance_name = argv[1];
+    instance_name = instance_name.substr(instance_name.rfind('/') + 1);
+    for (int i = 2; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--trajectory") == 0) trajectory_path = argv[i + 1];
+    }
+    if (!run_heur(instance, vector<string>(argv + 2, argv + argc), 0, result)) {
+        exit(1);
+    }
+    anytime_finish(result);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#ifndef INCUMBENT_CHANNEL_H
+#define INCUMBENT_CHANNEL_H
+
+/*
+ * Incumbent shared by the engines of a portfolio run through POSIX shared memory. It is plain C so
+ * pli-solver.c can use it too. The cost is monotone and can be read at any time to prune, the scene
+ * order is guarded by a sequence number that is odd while a writer is copying it (seqlock).
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define CHANNEL_MAX_SCENES 4096
+#define CHANNEL_WRITE_TRIES 100000
+
+typedef struct IncumbentChannel {
+    unsigned long sequence;
+    int writer;
+    unsigned long cost;
+    unsigned long bound;
+    int scenes_num;
+    int order[CHANNEL_MAX_SCENES];
+    char source[16];
+} IncumbentChannel;
+
+/**
+ * Maps the channel with the given shm name, the creator initializes it with no incumbent
+ * @return NULL if it could not be mapped
+ */
+static inline IncumbentChannel *channel_open(const char *name, int create) {
+    IncumbentChannel *channel;
+    int fd = shm_open(name, create ? O_CREAT | O_RDWR | O_TRUNC : O_RDWR, 0600);
+    if (fd == -1) return NULL;
+    if (create && ftruncate(fd, sizeof(IncumbentChannel)) != 0) {
+        close(fd);
+        return NULL;
+    }
+    channel = (IncumbentChannel *) mmap(NULL, sizeof(IncumbentChannel), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (channel == MAP_FAILED) return NULL;
+    if (create) {
+        memset(channel, 0, sizeof(IncumbentChannel));
+        channel->cost = ULONG_MAX;
+        __atomic_store_n(&channel->sequence, 0, __ATOMIC_RELEASE);
+    }
+    return channel;
+}
+
+static inline unsigned long channel_cost(IncumbentChannel *channel) {
+    return __atomic_load_n(&channel->cost, __ATOMIC_ACQUIRE);
+}
+
+static inline unsigned long channel_bound(IncumbentChannel *channel) {
+    return __atomic_load_n(&channel->bound, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Whether the sequence is held odd by a writer that was killed while copying, it never releases it
+ */
+static inline int channel_abandoned(IncumbentChannel *channel) {
+    int writer = __atomic_load_n(&channel->writer, __ATOMIC_RELAXED);
+    return writer > 0 && kill(writer, 0) == -1 && errno == ESRCH;
+}
+
+/**
+ * Publishes the scene order if it is better than the shared one. Writers claim the channel by
+ * making the sequence odd, giving up after CHANNEL_WRITE_TRIES. A sequence that stayed odd all along
+ * because its writer was killed is taken over: the cost is stored after the order, so the order of
+ * the shared cost is whole and a torn copy is redone by a better one
+ * @return 1 if the order was published
+ */
+static inline int channel_publish(IncumbentChannel *channel, unsigned long cost, const int *order, int scenes_num,
+                                  const char *source) {
+    unsigned long sequence, first = 0;
+    int tries, published = 0;
+    if (scenes_num > CHANNEL_MAX_SCENES) return 0;
+    for (tries = 0; tries < CHANNEL_WRITE_TRIES; tries++) {
+        if (cost >= channel_cost(channel)) return 0;
+        sequence = __atomic_load_n(&channel->sequence, __ATOMIC_RELAXED);
+        if (tries == 0) first = sequence;
+        if (!(sequence & 1) &&
+            __atomic_compare_exchange_n(&channel->sequence, &sequence, sequence + 1, 0, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    if (tries == CHANNEL_WRITE_TRIES) {
+        // claims the stale odd sequence s as s + 2 and releases it as s + 3
+        if (sequence != first || !(sequence & 1) || !channel_abandoned(channel) ||
+            !__atomic_compare_exchange_n(&channel->sequence, &sequence, sequence + 2, 0, __ATOMIC_ACQUIRE,
+                                         __ATOMIC_RELAXED)) {
+            return 0;
+        }
+        sequence++;
+    }
+    __atomic_store_n(&channel->writer, (int) getpid(), __ATOMIC_RELAXED);
+    if (cost < channel->cost) {
+        memcpy(channel->order, order, sizeof(int) * scenes_num);
+        channel->scenes_num = scenes_num;
+        strncpy(channel->source, source, sizeof(channel->source) - 1);
+        __atomic_store_n(&channel->cost, cost, __ATOMIC_RELEASE);
+        published = 1;
+    }
+    __atomic_store_n(&channel->sequence, sequence + 2, __ATOMIC_RELEASE);
+    return published;
+}
+
+/**
+ * Raises the shared lower bound
+ */
+static inline void channel_publish_bound(IncumbentChannel *channel, unsigned long bound) {
+    unsigned long current = channel_bound(channel);
+    while (bound > current &&
+           !__atomic_compare_exchange_n(&channel->bound, &current, bound, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * Copies a consistent snapshot of the shared incumbent into order and source (16 chars), giving up
+ * after CHANNEL_WRITE_TRIES like the writers
+ * @return its cost, ULONG_MAX with no scenes if there is none or no snapshot could be taken
+ */
+static inline unsigned long channel_read(IncumbentChannel *channel, int *order, int *scenes_num, char *source) {
+    unsigned long before, after, cost;
+    int tries;
+    for (tries = 0; tries < CHANNEL_WRITE_TRIES; tries++) {
+        before = __atomic_load_n(&channel->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+        cost = channel->cost;
+        *scenes_num = channel->scenes_num;
+        if (cost != ULONG_MAX) {
+            memcpy(order, channel->order, sizeof(int) * *scenes_num);
+        }
+        if (source != NULL) memcpy(source, channel->source, sizeof(channel->source));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&channel->sequence, __ATOMIC_RELAXED);
+        if (before == after) return cost;
+    }
+    *scenes_num = 0;
+    if (source != NULL) source[0] = '\0';
+    return ULONG_MAX;
+}
+
+#endif
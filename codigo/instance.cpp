@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "instance.h"
+
+/**
+ * Whether the byte separates numbers: whitespace or one of separators
+ */
+static bool is_separator(char byte, const char *separators) {
+    return isspace((unsigned char) byte) || (byte != '\0' && strchr(separators, byte) != NULL);
+}
+
+/**
+ * Reads the next unsigned integer, skipping whitespace and separators. Any other byte before or right
+ * after the digits, as a sign or an exponent, makes the input malformed
+ * @return false if the end of the buffer was reached first or the number is malformed
+ */
+static bool scan_number(const char *&position, const char *end, unsigned long &value, const char *separators = "") {
+    while (position < end && is_separator(*position, separators)) position++;
+    if (position == end || (unsigned) (*position - '0') > 9) return false;
+    value = 0;
+    unsigned digit;
+    while (position < end && (digit = (unsigned) (*position - '0')) <= 9) {
+        value = value * 10 + digit;
+        position++;
+    }
+    return position == end || is_separator(*position, separators);
+}
+
+void resize_instance(Instance &instance, unsigned long days_num, unsigned long actors_num) {
+    instance.days_num = days_num;
+    instance.actors_num = actors_num;
+    instance.words = (days_num + 63) / 64;
+    instance.actors_scenes.assign(actors_num * instance.words, 0);
+    instance.actors_cost.assign(actors_num, 0);
+}
+
+unsigned long long hash_instance(const Instance &instance) {
+    uint32_t days_num = (uint32_t) instance.days_num, actors_num = (uint32_t) instance.actors_num;
+    uint64_t hash = fnv1a(FNV_OFFSET, &days_num, sizeof(days_num));
+    hash = fnv1a(hash, &actors_num, sizeof(actors_num));
+    if (!instance.actors_scenes.empty()) {
+        hash = fnv1a(hash, &instance.actors_scenes[0], instance.actors_scenes.size() * sizeof(uint64_t));
+    }
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        uint64_t cost = instance.actors_cost[actor];
+        hash = fnv1a(hash, &cost, sizeof(cost));
+    }
+    return hash;
+}
+
+void index_instance(Instance &instance) {
+    instance.actors_words = (instance.actors_num + 63) / 64;
+    instance.scenes_actors.assign(instance.days_num * instance.actors_words, 0);
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        for (unsigned long scene = 0; scene < instance.days_num; ++scene) {
+            if (instance.on_scene(actor, scene)) {
+                instance.scenes_actors[scene * instance.actors_words + actor / 64] |= 1ULL << (actor % 64);
+            }
+        }
+    }
+    instance.hash = hash_instance(instance);
+}
+
+/**
+ * Root of the scene on the union-find forest, halving the path on the way
+ */
+static unsigned long find_root(std::vector<unsigned long> &parent, unsigned long scene) {
+    while (parent[scene] != scene) {
+        parent[scene] = parent[parent[scene]];
+        scene = parent[scene];
+    }
+    return scene;
+}
+
+std::vector<std::vector<int> > scene_components(const Instance &instance) {
+    std::vector<unsigned long> parent(instance.days_num);
+    for (unsigned long scene = 0; scene < instance.days_num; ++scene) {
+        parent[scene] = scene;
+    }
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        long first = -1;
+        for (unsigned long scene = 0; scene < instance.days_num; ++scene) {
+            if (!instance.on_scene(actor, scene)) continue;
+            if (first == -1) {
+                first = (long) scene;
+                continue;
+            }
+            unsigned long first_root = find_root(parent, (unsigned long) first), root = find_root(parent, scene);
+            parent[std::max(first_root, root)] = std::min(first_root, root);
+        }
+    }
+    // the root of a component is its first scene, so the components come out sorted by it
+    std::vector<std::vector<int> > components;
+    std::vector<long> component(instance.days_num, -1);
+    for (unsigned long scene = 0; scene < instance.days_num; ++scene) {
+        unsigned long root = find_root(parent, scene);
+        if (component[root] == -1) {
+            component[root] = (long) components.size();
+            components.push_back(std::vector<int>());
+        }
+        components[component[root]].push_back((int) scene);
+    }
+    return components;
+}
+
+void sub_instance(const Instance &instance, const std::vector<int> &scenes, Instance &part) {
+    std::vector<unsigned long> actors;
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        for (int k = 0; k < scenes.size(); ++k) {
+            if (instance.on_scene(actor, scenes[k])) {
+                actors.push_back(actor);
+                break;
+            }
+        }
+    }
+    resize_instance(part, scenes.size(), actors.size());
+    for (unsigned long actor = 0; actor < actors.size(); ++actor) {
+        unsigned long long *row = &part.actors_scenes[actor * part.words];
+        for (unsigned long scene = 0; scene < scenes.size(); ++scene) {
+            row[scene / 64] |= (unsigned long long) instance.on_scene(actors[actor], scenes[scene]) << (scene % 64);
+        }
+        part.actors_cost[actor] = instance.actors_cost[actors[actor]];
+    }
+    index_instance(part);
+}
+
+/**
+ * Parses a .txt instance: scenes, actors, the 0/1 matrix with one actor per line and the actors cost
+ * @return false if the text ends before the whole instance was read
+ */
+static bool parse_instance(const char *position, const char *end, Instance &instance) {
+    unsigned long days_num, actors_num, value;
+    if (!scan_number(position, end, days_num) || !scan_number(position, end, actors_num)) {
+        return false;
+    }
+    resize_instance(instance, days_num, actors_num);
+    for (unsigned long actor = 0; actor < actors_num; ++actor) {
+        unsigned long long *row = &instance.actors_scenes[actor * instance.words];
+        for (unsigned long scene = 0; scene < days_num; ++scene) {
+            if (!scan_number(position, end, value)) return false;
+            row[scene / 64] |= (unsigned long long) (value != 0) << (scene % 64);
+        }
+    }
+    for (unsigned long actor = 0; actor < actors_num; ++actor) {
+        if (!scan_number(position, end, instance.actors_cost[actor])) return false;
+    }
+    return true;
+}
+
+/**
+ * Moves position past the next occurrence of text
+ * @return false if there is none
+ */
+static bool skip_past(const char *&position, const char *end, const char *text) {
+    const char *found = std::search(position, end, text, text + strlen(text));
+    if (found == end) return false;
+    position = found + strlen(text);
+    return true;
+}
+
+/**
+ * Punctuation around the numbers of a MathProg instance
+ */
+static const char *mathprog_separators = ":=;";
+
+/**
+ * Parses a MathProg .dat instance as written by write_mathprog, the row and actor indexes are skipped
+ * @return false if a parameter is missing or incomplete
+ */
+static bool parse_mathprog(const char *position, const char *end, Instance &instance) {
+    unsigned long days_num, actors_num, value;
+    if (!skip_past(position, end, "param n") || !scan_number(position, end, days_num, mathprog_separators) ||
+        !skip_past(position, end, "param m") || !scan_number(position, end, actors_num, mathprog_separators) ||
+        !skip_past(position, end, "param T") || !skip_past(position, end, ":=")) {
+        return false;
+    }
+    resize_instance(instance, days_num, actors_num);
+    for (unsigned long actor = 0; actor < actors_num; ++actor) {
+        unsigned long long *row = &instance.actors_scenes[actor * instance.words];
+        if (!scan_number(position, end, value, mathprog_separators)) return false;
+        for (unsigned long scene = 0; scene < days_num; ++scene) {
+            if (!scan_number(position, end, value, mathprog_separators)) return false;
+            row[scene / 64] |= (unsigned long long) (value != 0) << (scene % 64);
+        }
+    }
+    if (!skip_past(position, end, "param c") || !skip_past(position, end, ":=")) return false;
+    for (unsigned long actor = 0; actor < actors_num; ++actor) {
+        if (!scan_number(position, end, value, mathprog_separators) ||
+            !scan_number(position, end, instance.actors_cost[actor], mathprog_separators)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Copies a binary instance, checking its size and hash
+ * @return false if the file is truncated or corrupted
+ */
+static bool parse_binary(const char *data, size_t size, Instance &instance) {
+    InstanceHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (!instance_header_valid(&header) || size != sizeof(header) + instance_body_size(&header)) return false;
+    const char *body = data + sizeof(header);
+    if (instance_hash(header.days_num, header.actors_num, body, instance_body_size(&header)) != header.hash) {
+        return false;
+    }
+    resize_instance(instance, header.days_num, header.actors_num);
+    size_t rows_size = instance.actors_scenes.size() * sizeof(uint64_t);
+    if (rows_size > 0) memcpy(&instance.actors_scenes[0], body, rows_size);
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        uint64_t cost;
+        memcpy(&cost, body + rows_size + actor * sizeof(uint64_t), sizeof(cost));
+        instance.actors_cost[actor] = (unsigned long) cost;
+    }
+    return true;
+}
+
+bool load_instance(const char *path, Instance &instance) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return false;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    const char *text = (const char *) data, *end = text + file_stat.st_size, *param = "param";
+    bool loaded;
+    if ((size_t) file_stat.st_size >= sizeof(InstanceHeader) && memcmp(text, INSTANCE_MAGIC, 4) == 0) {
+        loaded = parse_binary(text, file_stat.st_size, instance);
+    } else if (std::search(text, end, param, param + 5) != end) {
+        loaded = parse_mathprog(text, end, instance);
+    } else {
+        loaded = parse_instance(text, end, instance);
+    }
+    if (loaded) index_instance(instance);
+    munmap(data, file_stat.st_size);
+    return loaded;
+}
+
+static void write_text(FILE *file, const Instance &instance) {
+    fprintf(file, "%lu\n%lu\n", instance.days_num, instance.actors_num);
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        for (unsigned long scene = 0; scene < instance.days_num; ++scene) {
+            fprintf(file, scene + 1 < instance.days_num ? "%d " : "%d\n", (int) instance.on_scene(actor, scene));
+        }
+    }
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        fprintf(file, actor + 1 < instance.actors_num ? "%lu " : "%lu\n", instance.actors_cost[actor]);
+    }
+}
+
+static void write_mathprog(FILE *file, const Instance &instance) {
+    fprintf(file, "data;\nparam n := %lu;\nparam m := %lu;\nparam T :", instance.days_num, instance.actors_num);
+    for (unsigned long scene = 0; scene < instance.days_num; ++scene) fprintf(file, " %lu", scene + 1);
+    fprintf(file, " :=\n");
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        fprintf(file, " %lu", actor + 1);
+        for (unsigned long scene = 0; scene < instance.days_num; ++scene) {
+            fprintf(file, " %d", (int) instance.on_scene(actor, scene));
+        }
+        fprintf(file, actor + 1 < instance.actors_num ? "\n" : ";\n");
+    }
+    fprintf(file, "param c :=\n");
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        fprintf(file, actor + 1 < instance.actors_num ? " %lu %lu\n" : " %lu %lu;\n", actor + 1,
+                instance.actors_cost[actor]);
+    }
+    fprintf(file, "end;\n");
+}
+
+static void write_binary(FILE *file, const Instance &instance) {
+    InstanceHeader header;
+    memcpy(header.magic, INSTANCE_MAGIC, 4);
+    header.version = INSTANCE_VERSION;
+    header.days_num = (uint32_t) instance.days_num;
+    header.actors_num = (uint32_t) instance.actors_num;
+    header.hash = hash_instance(instance);
+    fwrite(&header, sizeof(header), 1, file);
+    if (!instance.actors_scenes.empty()) {
+        fwrite(&instance.actors_scenes[0], sizeof(uint64_t), instance.actors_scenes.size(), file);
+    }
+    for (unsigned long actor = 0; actor < instance.actors_num; ++actor) {
+        uint64_t cost = instance.actors_cost[actor];
+        fwrite(&cost, sizeof(cost), 1, file);
+    }
+}
+
+bool save_instance(const char *path, const Instance &instance) {
+    size_t length = strlen(path);
+    bool binary = length > 4 && strcmp(path + length - 4, ".bin") == 0;
+    FILE *file = fopen(path, binary ? "wb" : "w");
+    if (file == NULL) return false;
+    if (binary) {
+        write_binary(file, instance);
+    } else if (length > 4 && strcmp(path + length - 4, ".dat") == 0) {
+        write_mathprog(file, instance);
+    } else {
+        write_text(file, instance);
+    }
+    return fclose(file) == 0;
+}
+
+static bool has_instance_extension(const std::string &name) {
+    if (name.size() < 4) return false;
+    std::string extension = name.substr(name.size() - 4);
+    return extension == ".txt" || extension == ".dat" || extension == ".bin";
+}
+
+std::vector<std::string> list_instances(const std::string &path) {
+    std::vector<std::string> paths;
+    DIR *dir = opendir(path.c_str());
+    if (dir == NULL) {
+        paths.push_back(path);
+        return paths;
+    }
+    struct dirent *file;
+    while ((file = readdir(dir)) != NULL) {
+        if (has_instance_extension(file->d_name)) paths.push_back(path + "/" + file->d_name);
+    }
+    closedir(dir);
+    sort(paths.begin(), paths.end());
+    return paths;
+}
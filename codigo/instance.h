@@ -0,0 +1,77 @@
+#ifndef INSTANCE_H
+#define INSTANCE_H
+
+#include <string>
+#include <vector>
+#include "instance_format.h"
+
+/**
+ * Instance data, the actor-scene matrix is packed in rows of 64 bit words, one row per actor, and
+ * transposed in scenes_actors, one row of actors_words words per scene. The hash identifies the
+ * instance whatever format it was read from (see instance_format.h)
+ */
+typedef struct Instance {
+    unsigned long days_num;
+    unsigned long actors_num;
+    unsigned long words;
+    unsigned long actors_words;
+    std::vector<unsigned long long> actors_scenes;
+    std::vector<unsigned long long> scenes_actors;
+    std::vector<unsigned long> actors_cost;
+    unsigned long long hash;
+
+    bool on_scene(unsigned long actor, unsigned long scene) const {
+        return (actors_scenes[actor * words + scene / 64] >> (scene % 64)) & 1;
+    }
+
+    const unsigned long long *actor_row(unsigned long actor) const {
+        return &actors_scenes[actor * words];
+    }
+
+    const unsigned long long *scene_row(unsigned long scene) const {
+        return &scenes_actors[scene * actors_words];
+    }
+} Instance;
+
+/**
+ * Allocates the matrix and costs of an instance of days_num scenes and actors_num actors, all zero
+ */
+void resize_instance(Instance &instance, unsigned long days_num, unsigned long actors_num);
+
+unsigned long long hash_instance(const Instance &instance);
+
+/**
+ * Fills the scene rows and the hash once the actor rows and costs are set
+ */
+void index_instance(Instance &instance);
+
+/**
+ * Groups the scenes by the connected components of the actor-scene graph, scenes sharing an actor are
+ * on the same component. The components are sorted by their first scene
+ */
+std::vector<std::vector<int> > scene_components(const Instance &instance);
+
+/**
+ * The instance restricted to the scenes and to the actors on them, scene k of part is scenes[k]
+ */
+void sub_instance(const Instance &instance, const std::vector<int> &scenes, Instance &part);
+
+/**
+ * Maps the instance file in memory and reads it without copying the text. The format is detected
+ * from the content: binary (.bin), MathProg (.dat) or the plain matrix (.txt)
+ * @return false if the file could not be read or is incomplete
+ */
+bool load_instance(const char *path, Instance &instance);
+
+/**
+ * Writes the instance in the format given by the extension of path: .bin, .dat or .txt
+ * @return false if the file could not be written
+ */
+bool save_instance(const char *path, const Instance &instance);
+
+/**
+ * The instance files (.txt, .dat or .bin) of a directory sorted by name, or path itself if it is a file
+ */
+std::vector<std::string> list_instances(const std::string &path);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef INSTANCE_FORMAT_H
+#define INSTANCE_FORMAT_H
+
+/*
+ * Binary instance format (.bin), plain C so pli-solver.c can read it too. The file is the header
+ * followed by actors_num rows of (days_num + 63) / 64 words with bit j of a row set if the actor is on
+ * scene j, and then the actors_num costs. Every field is little-endian and the hash is the FNV-1a of
+ * days_num, actors_num, the rows and the costs, so the same instance has the same hash in any format.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define INSTANCE_MAGIC "TSBI"
+#define INSTANCE_VERSION 1
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+typedef struct InstanceHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t days_num;
+    uint32_t actors_num;
+    uint64_t hash;
+} InstanceHeader;
+
+static inline uint64_t fnv1a(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    size_t k;
+    for (k = 0; k < size; k++) {
+        hash ^= bytes[k];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static inline int instance_header_valid(const InstanceHeader *header) {
+    return memcmp(header->magic, INSTANCE_MAGIC, 4) == 0 && header->version == INSTANCE_VERSION;
+}
+
+/**
+ * Size in bytes of the rows and costs that follow the header
+ */
+static inline size_t instance_body_size(const InstanceHeader *header) {
+    return (size_t) header->actors_num * ((header->days_num + 63) / 64) * sizeof(uint64_t) +
+           (size_t) header->actors_num * sizeof(uint64_t);
+}
+
+/**
+ * Hash of an instance whose rows and costs are stored contiguously as in the file
+ */
+static inline uint64_t instance_hash(uint32_t days_num, uint32_t actors_num, const void *body, size_t body_size) {
+    uint64_t hash = fnv1a(FNV_OFFSET, &days_num, sizeof(days_num));
+    hash = fnv1a(hash, &actors_num, sizeof(actors_num));
+    return fnv1a(hash, body, body_size);
+}
+
+#endif
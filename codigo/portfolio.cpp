@@ -0,0 +1,207 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <csignal>
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "incumbent_channel.h"
+
+using namespace std;
+
+/**
+ * Engine of the portfolio, run as a child process sharing the incumbent channel
+ */
+typedef struct Engine {
+    string name;
+    vector<string> args;
+    pid_t pid;
+    bool running;
+} Engine;
+
+/**
+ * Seconds given to the engines to print their results after SIGINT
+ */
+unsigned int stop_tolerance = 5;
+vector<Engine> engines;
+
+/**
+ * Set by SIGINT or SIGTERM, the portfolio then stops the engines, reports the shared incumbent and
+ * removes the shared memory as if the time limit was reached
+ */
+volatile sig_atomic_t interrupted = 0;
+
+void interrupt_portfolio(int signum) {
+    interrupted = 1;
+}
+
+void add_engine(const string &directory, const string &name, const string &instance, const string &shm_name,
+                const char *extra_args) {
+    Engine engine;
+    engine.name = name;
+    engine.args.push_back(directory + name);
+    engine.args.push_back(instance);
+    for (const char *arg = extra_args; *arg;) {
+        const char *end = arg;
+        while (*end && *end != ' ') end++;
+        engine.args.push_back(string(arg, end));
+        arg = *end ? end + 1 : end;
+    }
+    engine.args.push_back("--shared");
+    engine.args.push_back(shm_name);
+    engine.pid = -1;
+    engine.running = false;
+    if (access(engine.args[0].c_str(), X_OK) == 0) {
+        engines.push_back(engine);
+    }
+}
+
+void launch(Engine &engine) {
+    engine.pid = fork();
+    if (engine.pid == 0) {
+        // the engines outputs are replaced by the portfolio one
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        vector<char *> argv;
+        for (int i = 0; i < engine.args.size(); ++i) {
+            argv.push_back(const_cast<char *>(engine.args[i].c_str()));
+        }
+        argv.push_back(NULL);
+        execv(argv[0], &argv[0]);
+        _exit(127);
+    }
+    engine.running = engine.pid > 0;
+}
+
+/**
+ * Marks the engine of pid as finished
+ * @return its index
+ */
+int finished(pid_t pid) {
+    for (int i = 0; i < engines.size(); ++i) {
+        if (engines[i].pid == pid) {
+            engines[i].running = false;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Interrupts the engines still running, killing the ones that do not stop within stop_tolerance
+ */
+void stop_engines() {
+    for (int i = 0; i < engines.size(); ++i) {
+        if (engines[i].running) kill(engines[i].pid, SIGINT);
+    }
+    time_t deadline = time(NULL) + stop_tolerance;
+    bool running = true;
+    while (running && time(NULL) < deadline) {
+        pid_t pid;
+        while ((pid = waitpid(-1, NULL, WNOHANG)) > 0) finished(pid);
+        running = false;
+        for (int i = 0; i < engines.size(); ++i) running = running || engines[i].running;
+        if (running) usleep(10000);
+    }
+    for (int i = 0; i < engines.size(); ++i) {
+        if (engines[i].running) {
+            kill(engines[i].pid, SIGKILL);
+            waitpid(engines[i].pid, NULL, 0);
+            engines[i].running = false;
+        }
+    }
+}
+
+/**
+ * Main function, runs bnb, heur and pli-solver on the instance sharing their incumbents and reports
+ * the best solution once the first of them finishes or the time limit is reached
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] contains the path of the entry_file, argv[2] the time limit in seconds (180)
+ * @return 0 in case of success
+ */
+int main(int argc, const char *argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " <instancia.txt> [tempo limite]" << endl;
+        exit(1);
+    }
+    string instance = argv[1];
+    unsigned int time_limit = argc > 2 ? (unsigned int) atoi(argv[2]) : 180;
+
+    // shared incumbent
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "/mc658-portfolio-%d", (int) getpid());
+    IncumbentChannel *channel = channel_open(shm_name, 1);
+    if (channel == NULL) {
+        cerr << "Não foi possível criar a memória compartilhada " << shm_name << endl;
+        exit(1);
+    }
+    struct sigaction action;
+    action.sa_handler = interrupt_portfolio;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // engines are looked up next to the portfolio binary
+    string directory = argv[0];
+    directory = directory.find('/') == string::npos ? "./" : directory.substr(0, directory.rfind('/') + 1);
+    add_engine(directory, "bnb", instance, shm_name, "");
+    add_engine(directory, "heur", instance, shm_name, "--lns --adaptive");
+    add_engine(directory, "pli-solver", instance, shm_name, "");
+    if (engines.empty()) {
+        cerr << "Nenhum executável bnb, heur ou pli-solver encontrado em " << directory << endl;
+        shm_unlink(shm_name);
+        exit(1);
+    }
+    for (int i = 0; i < engines.size(); ++i) {
+        launch(engines[i]);
+    }
+
+    // waits for the first engine to finish, one that crashes or fails leaves the others running
+    time_t deadline = time(NULL) + time_limit;
+    int winner = -1;
+    bool running = true;
+    while (winner == -1 && running && !interrupted && time(NULL) < deadline) {
+        int status;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid > 0) {
+            int engine = finished(pid);
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                winner = engine;
+            } else if (engine != -1) {
+                cerr << engines[engine].name << " terminou sem solução" << endl;
+            }
+        } else {
+            usleep(10000);
+        }
+        running = false;
+        for (int i = 0; i < engines.size(); ++i) running = running || engines[i].running;
+    }
+    stop_engines();
+
+    vector<int> order(CHANNEL_MAX_SCENES);
+    int scenes_num = 0;
+    char source[16];
+    unsigned long cost = channel_read(channel, &order[0], &scenes_num, source);
+    unsigned long bound = channel_bound(channel);
+    if (cost != ULONG_MAX) {
+        for (int l = 0; l < scenes_num; ++l) {
+            cout << order[l] << " ";
+        }
+        cout << endl << cost << endl;
+    } else {
+        cout << endl << "-" << endl;
+        source[0] = '\0';
+    }
+    cout << (cost != ULONG_MAX && bound >= cost ? cost : bound) << endl;
+    cout << (winner != -1 ? engines[winner].name : !running ? "falha" : interrupted ? "interrompido" : "tempo") << " "
+         << source << endl;
+    munmap(channel, sizeof(IncumbentChannel));
+    shm_unlink(shm_name);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "schedule.h"
+
+using namespace std;
+
+vector<ActorLkup> build_actors_lkup(const Instance &instance) {
+    vector<ActorLkup> actors_lkup(instance.actors_num);
+    for (unsigned long i = 0; i < instance.actors_num; ++i) {
+        actors_lkup[i].cost = instance.actors_cost[i];
+        actors_lkup[i].total_scenes = 0;
+        for (unsigned long w = 0; w < instance.words; ++w) {
+            actors_lkup[i].total_scenes += __builtin_popcountll(instance.actor_row(i)[w]);
+        }
+    }
+    return actors_lkup;
+}
+
+unsigned long schedule_cost(const Instance &instance, const vector<int> &scene_order) {
+    unsigned long cost = 0;
+    for (unsigned long i = 0; i < instance.actors_num; ++i) {
+        int first = -1, last = -1, shot = 0;
+        for (int d = 0; d < scene_order.size(); ++d) {
+            if (instance.on_scene(i, scene_order[d])) {
+                if (first == -1) first = d;
+                last = d;
+                shot++;
+            }
+        }
+        if (first != -1) {
+            cost += (unsigned long) (last - first + 1 - shot) * instance.actors_cost[i];
+        }
+    }
+    return cost;
+}
+
+unsigned long actors_mask_cost(const Instance &instance, const unsigned long long *mask) {
+    unsigned long cost = 0;
+    for (unsigned long w = 0; w < instance.actors_words; ++w) {
+        unsigned long long bits = mask[w];
+        while (bits) {
+            int bit = __builtin_ctzll(bits);
+            cost += instance.actors_cost[w * 64 + bit];
+            bits &= bits - 1;
+        }
+    }
+    return cost;
+}
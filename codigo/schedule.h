@@ -0,0 +1,28 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <vector>
+#include "instance.h"
+
+/**
+ * ActorLkup data definition
+ */
+typedef struct ActorLkup {
+    int total_scenes;
+    unsigned long cost;
+} ActorLkup;
+
+std::vector<ActorLkup> build_actors_lkup(const Instance &instance);
+
+/**
+ * Waiting cost of a complete scene order, every actor pays for the days between its first and last
+ * scenes on which it is not shot
+ */
+unsigned long schedule_cost(const Instance &instance, const std::vector<int> &scene_order);
+
+/**
+ * Sums the cost of the actors on the mask, a row of instance.actors_words words
+ */
+unsigned long actors_mask_cost(const Instance &instance, const unsigned long long *mask);
+
+#endif
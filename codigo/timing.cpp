@@ -0,0 +1,12 @@
+#include <ctime>
+#include "timing.h"
+
+double cpu_seconds() {
+    return (double) clock() / CLOCKS_PER_SEC;
+}
+
+double wall_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
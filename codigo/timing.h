@@ -0,0 +1,14 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+/**
+ * CPU time of the process, in seconds
+ */
+double cpu_seconds();
+
+/**
+ * Monotonic wall clock time, in seconds
+ */
+double wall_seconds();
+
+#endif
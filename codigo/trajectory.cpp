@@ -0,0 +1,211 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Incumbent improvements of one run of an engine on an instance, read from a trajectory log
+ */
+typedef struct Run {
+    string label;
+    string instance;
+    vector<double> times;
+    vector<double> costs;
+} Run;
+
+double gap = 0;
+double horizon = 0;
+vector<Run> runs;
+map<string, double> targets;
+
+/**
+ * Label of the runs of a log, its file name without directories and extension
+ */
+string log_label(const string &path) {
+    string label = path.substr(path.rfind('/') + 1);
+    return label.substr(0, label.rfind('.'));
+}
+
+/**
+ * Reads the runs of a log written by write_trajectory, a run ends when the instance changes or the
+ * time goes back, which happens when runs are appended to the same file
+ */
+bool read_log(const char *path) {
+    ifstream file(path);
+    if (!file) return false;
+    string label = log_label(path);
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line.compare(0, 9, "Instancia") == 0) continue;
+        stringstream fields(line);
+        string instance, engine, time, cost;
+        getline(fields, instance, ';');
+        getline(fields, engine, ';');
+        getline(fields, time, ';');
+        getline(fields, cost, ';');
+        double event_time = atof(time.c_str());
+        if (runs.empty() || runs.back().label != label || runs.back().instance != instance ||
+            event_time < runs.back().times.back()) {
+            Run run;
+            run.label = label;
+            run.instance = instance;
+            runs.push_back(run);
+        }
+        runs.back().times.push_back(event_time);
+        runs.back().costs.push_back(atof(cost.c_str()));
+    }
+    return true;
+}
+
+/**
+ * Reads the target cost of the instances from a file of lines Instancia;Alvo
+ */
+bool read_targets(const char *path) {
+    ifstream file(path);
+    if (!file) return false;
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line.compare(0, 9, "Instancia") == 0) continue;
+        stringstream fields(line);
+        string instance, target;
+        getline(fields, instance, ';');
+        getline(fields, target, ';');
+        targets[instance] = atof(target.c_str());
+    }
+    return true;
+}
+
+/**
+ * Targets of the instances without one, the best cost found by any run within gap of it
+ */
+void default_targets() {
+    map<string, double> best;
+    for (int r = 0; r < runs.size(); ++r) {
+        const Run &run = runs[r];
+        double cost = *min_element(run.costs.begin(), run.costs.end());
+        if (best.count(run.instance) == 0 || cost < best[run.instance]) best[run.instance] = cost;
+    }
+    for (map<string, double>::iterator it = best.begin(); it != best.end(); ++it) {
+        if (targets.count(it->first) == 0) targets[it->first] = floor(it->second * (1 + gap));
+    }
+}
+
+/**
+ * Time-to-target curves, the empirical distribution of the time each label takes to reach the target
+ * of the instances, a run that never reaches it counts in the fraction but adds no point
+ */
+void time_to_target() {
+    map<string, vector<double> > times;
+    map<string, int> runs_num;
+    for (int r = 0; r < runs.size(); ++r) {
+        const Run &run = runs[r];
+        runs_num[run.label]++;
+        for (int k = 0; k < run.times.size(); ++k) {
+            if (run.costs[k] <= targets[run.instance]) {
+                times[run.label].push_back(run.times[k]);
+                break;
+            }
+        }
+    }
+    cout << "Rotulo;Tempo;Fracao" << endl;
+    for (map<string, int>::iterator it = runs_num.begin(); it != runs_num.end(); ++it) {
+        vector<double> &label_times = times[it->first];
+        sort(label_times.begin(), label_times.end());
+        for (int k = 0; k < label_times.size(); ++k) {
+            cout << it->first << ";" << label_times[k] << ";" << (double) (k + 1) / it->second << endl;
+        }
+    }
+}
+
+/**
+ * Primal gap of a cost to the target, 0 if it reaches the target and 1 at most
+ */
+double primal_gap(double cost, double target) {
+    if (cost <= target) return 0;
+    double largest = max(fabs(cost), fabs(target));
+    return largest > 0 ? min(1.0, fabs(cost - target) / largest) : 0;
+}
+
+/**
+ * Primal integral of each run up to the horizon, the integral over time of the primal gap of the
+ * incumbent, which is 1 before the first one. Lower values mean good solutions found earlier
+ */
+void primal_integral() {
+    if (horizon == 0) {
+        for (int r = 0; r < runs.size(); ++r) horizon = max(horizon, runs[r].times.back());
+    }
+    map<string, double> sums;
+    map<string, int> runs_num;
+    cout << "Rotulo;Instancia;Integral" << endl;
+    for (int r = 0; r < runs.size(); ++r) {
+        const Run &run = runs[r];
+        double integral = 0, last_time = 0, last_gap = 1;
+        for (int k = 0; k < run.times.size() && run.times[k] < horizon; ++k) {
+            integral += (run.times[k] - last_time) * last_gap;
+            last_time = run.times[k];
+            last_gap = primal_gap(run.costs[k], targets[run.instance]);
+        }
+        integral += (horizon - last_time) * last_gap;
+        sums[run.label] += integral;
+        runs_num[run.label]++;
+        cout << run.label << ";" << run.instance << ";" << integral << endl;
+    }
+    for (map<string, double>::iterator it = sums.begin(); it != sums.end(); ++it) {
+        cout << it->first << ";media;" << it->second / runs_num[it->first] << endl;
+    }
+}
+
+/**
+ * Main function, analysis of the trajectory logs of bnb, heur and batch (--trajectory)
+ * @param argc num of arguments on the command line
+ * @param argv argv[1] the mode:
+ *             ttt <logs...> [--gap fraction] [--targets file]
+ *             integral <logs...> [--gap fraction] [--targets file] [--horizon s]
+ *             each log is a label, the target of an instance is given by the targets file
+ *             (Instancia;Alvo) or is the best cost of all the logs within gap of it
+ * @return 0 in case of success
+ */
+int main(int argc, const char *argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <ttt | integral> <trajetorias...> [--gap g] [--targets arquivo]"
+             << " [--horizon s]" << endl;
+        exit(1);
+    }
+    string mode = argv[1];
+    if (mode != "ttt" && mode != "integral") {
+        cerr << "Modo desconhecido " << mode << endl;
+        exit(1);
+    }
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--gap") == 0 && i + 1 < argc) {
+            gap = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc) {
+            horizon = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--targets") == 0 && i + 1 < argc) {
+            if (!read_targets(argv[++i])) {
+                cerr << "Não foi possível ler os alvos " << argv[i] << endl;
+                exit(1);
+            }
+        } else if (!read_log(argv[i])) {
+            cerr << "Não foi possível ler a trajetória " << argv[i] << endl;
+            exit(1);
+        }
+    }
+    default_targets();
+
+    if (mode == "ttt") {
+        time_to_target();
+    } else {
+        primal_integral();
+    }
+    return 0;
+}
@@ -2,19 +2,564 @@
 #include <stdlib.h>
 #include <glpk.h>
 #include <float.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "codigo/incumbent_channel.h"
+#include "codigo/instance_format.h"
 
 #define TLIM_PLI 180000
 
+/* instance read from a .txt or .bin file: n scenes, m actors, T[i*n+j] = 1 if actor i is on scene j */
+int n, m;
+int *T;
+double *c;
+int *s;
+
+/* formulations built directly through the API */
+#define FORM_POS 1 /* scene/day assignment, first and last day of each actor */
+#define FORM_ON 2  /* scene/day assignment, actor started/not finished/on location per day */
+int formulation = FORM_POS;
+
+/* sparse matrix in triplet form, 1-based as glp_load_matrix expects */
+int ne, ne_max;
+int *ia, *ja;
+double *ar;
+
+/* heuristic incumbent, fed to the branch-and-cut through GLP_IHEUR */
+#define HEUR_ROUND_FREQ 10 /* node LP solutions are rounded on every HEUR_ROUND_FREQ heuristic calls */
+int *heur_order;
+double *heur_x;
+double heur_cost = DBL_MAX;
+int heur_cols;
+int heur_pending; /* heur_order improved and was not given to GLPK yet */
+int heur_calls;
+
+/* problem-specific cuts separated through GLP_ICUTGEN */
+#define CUT_MAX_ROUNDS 5     /* separation rounds per node */
+#define CUT_MAX_PER_ROUND 50 /* cuts added per separation round */
+#define CUT_EPS 1e-4
+#define CUT_CLASS 101
+#define ROOT_CUT_ROUNDS 20   /* separation rounds on the root mode */
+int bit_words;
+unsigned long long *actor_bits; /* bit j of the row of actor i is set if the actor is on scene j */
+char *nested;                   /* nested[i * m + k] = 1 if the scenes of actor i are a subset of those of k */
+int cut_node = -1, cut_rounds, cut_count;
+int *cut_ind, *cut_scenes;
+double *cut_val, *cut_key;
+
+/* incumbent shared with the other engines of a portfolio run, NULL when running alone */
+IncumbentChannel *channel;
+int *channel_order;
+
 double bestDB = DBL_MIN;
 /* double bgap = 100; */
 int a_cnt; /* current number of active nodes */
 int n_cnt; /* current number of all (active and inactive) nodes; */
 int t_cnt; /* total number of nodes including those already removed */
 
+/* column of x[j][d], scene j shot on day d */
+int col_x(int j, int d) {
+    return j * n + d + 1;
+}
+
+/* FORM_POS columns: first and last day of actor i */
+int col_first(int i) {
+    return n * n + i + 1;
+}
+
+int col_last(int i) {
+    return n * n + m + i + 1;
+}
+
+/* FORM_ON columns: actor i started by day d, not finished by day d and on location on day d */
+int col_started(int i, int d) {
+    return n * n + i * n + d + 1;
+}
+
+int col_pending(int i, int d) {
+    return n * n + m * n + i * n + d + 1;
+}
+
+int col_on(int i, int d) {
+    return n * n + 2 * m * n + i * n + d + 1;
+}
+
+/* reads a .bin instance, checking its hash, the header was already read */
+int read_binary_instance(FILE *f, const InstanceHeader *header) {
+    size_t size = instance_body_size(header);
+    int words = (header->days_num + 63) / 64;
+    int i, j;
+    uint64_t *body = malloc(size);
+    if (fread(body, 1, size, f) != size ||
+        instance_hash(header->days_num, header->actors_num, body, size) != header->hash) {
+        free(body);
+        return 1;
+    }
+    n = header->days_num;
+    m = header->actors_num;
+    T = malloc(sizeof(int) * n * m);
+    c = malloc(sizeof(double) * m);
+    s = calloc(m, sizeof(int));
+    for (i = 0; i < m; i++) {
+        for (j = 0; j < n; j++) {
+            T[i * n + j] = (body[i * words + j / 64] >> (j % 64)) & 1;
+            s[i] += T[i * n + j];
+        }
+        c[i] = (double) body[m * words + i];
+    }
+    free(body);
+    return 0;
+}
+
+int read_instance(const char *path) {
+    FILE *f = fopen(path, "rb");
+    InstanceHeader header;
+    int i, j, ret;
+    if (f == NULL) return 1;
+    if (fread(&header, sizeof(header), 1, f) == 1 && instance_header_valid(&header)) {
+        ret = read_binary_instance(f, &header);
+        fclose(f);
+        return ret;
+    }
+    rewind(f);
+    if (fscanf(f, "%d %d", &n, &m) != 2) {
+        fclose(f);
+        return 1;
+    }
+    T = malloc(sizeof(int) * n * m);
+    c = malloc(sizeof(double) * m);
+    s = calloc(m, sizeof(int));
+    for (i = 0; i < m; i++)
+        for (j = 0; j < n; j++) {
+            if (fscanf(f, "%d", &T[i * n + j]) != 1) {
+                fclose(f);
+                return 1;
+            }
+            s[i] += T[i * n + j];
+        }
+    for (i = 0; i < m; i++)
+        if (fscanf(f, "%lf", &c[i]) != 1) {
+            fclose(f);
+            return 1;
+        }
+    fclose(f);
+    return 0;
+}
+
+void add_nz(int row, int col, double val) {
+    if (ne == ne_max) {
+        ne_max = 2 * ne_max + 1024;
+        ia = realloc(ia, sizeof(int) * (ne_max + 1));
+        ja = realloc(ja, sizeof(int) * (ne_max + 1));
+        ar = realloc(ar, sizeof(double) * (ne_max + 1));
+    }
+    ne++;
+    ia[ne] = row;
+    ja[ne] = col;
+    ar[ne] = val;
+}
+
+int add_row(glp_prob *mip, int type, double rhs) {
+    int row = glp_add_rows(mip, 1);
+    glp_set_row_bnds(mip, row, type, rhs, rhs);
+    return row;
+}
+
+/* waiting cost of shooting the scenes in the given order */
+double order_cost(const int *order) {
+    int i, k, first, last, count;
+    double cost = 0;
+    for (i = 0; i < m; i++) {
+        first = last = -1;
+        count = 0;
+        for (k = 0; k < n; k++)
+            if (T[i * n + order[k]]) {
+                if (first == -1) first = k;
+                last = k;
+                count++;
+            }
+        if (count) cost += c[i] * (last - first + 1 - count);
+    }
+    return cost;
+}
+
+/* appends the scene that makes the fewest started actors wait, then the one starting the fewest actors */
+void greedy_order(int *order) {
+    int *placed = calloc(n, sizeof(int));
+    int *shot = calloc(m, sizeof(int));
+    int i, j, k, best;
+    double cost, best_cost;
+    for (k = 0; k < n; k++) {
+        best = -1;
+        best_cost = DBL_MAX;
+        for (j = 0; j < n; j++) {
+            if (placed[j]) continue;
+            cost = 0;
+            for (i = 0; i < m; i++) {
+                if (!T[i * n + j] && shot[i] > 0 && shot[i] < s[i])
+                    cost += n * c[i];
+                else if (T[i * n + j] && shot[i] == 0 && s[i] > 1)
+                    cost += c[i];
+            }
+            if (cost < best_cost) {
+                best = j;
+                best_cost = cost;
+            }
+        }
+        placed[best] = 1;
+        order[k] = best;
+        for (i = 0; i < m; i++)
+            shot[i] += T[i * n + best];
+    }
+    free(placed);
+    free(shot);
+}
+
+/* moves single scenes to other positions while the cost improves, returns the final cost */
+double local_search(int *order) {
+    int *candidate = malloc(sizeof(int) * n);
+    int p, q, k, improved = 1;
+    double cost = order_cost(order), candidate_cost;
+    while (improved) {
+        improved = 0;
+        for (p = 0; p < n; p++)
+            for (q = 0; q < n; q++) {
+                if (p == q) continue;
+                memcpy(candidate, order, sizeof(int) * n);
+                if (p < q)
+                    for (k = p; k < q; k++) candidate[k] = order[k + 1];
+                else
+                    for (k = p; k > q; k--) candidate[k] = order[k - 1];
+                candidate[q] = order[p];
+                candidate_cost = order_cost(candidate);
+                if (candidate_cost < cost) {
+                    memcpy(order, candidate, sizeof(int) * n);
+                    cost = candidate_cost;
+                    improved = 1;
+                }
+            }
+    }
+    free(candidate);
+    return cost;
+}
+
+/* column values of the schedule given by order, x is 1-based */
+void fill_solution(const int *order, double *x) {
+    int i, j, k, first, last;
+    memset(x, 0, sizeof(double) * (heur_cols + 1));
+    for (k = 0; k < n; k++)
+        x[col_x(order[k], k)] = 1.0;
+    for (i = 0; i < m; i++) {
+        first = last = -1;
+        for (k = 0; k < n; k++)
+            if (T[i * n + order[k]]) {
+                if (first == -1) first = k;
+                last = k;
+            }
+        if (formulation == FORM_POS) {
+            x[col_first(i)] = first == -1 ? 1.0 : first + 1;
+            x[col_last(i)] = last == -1 ? 1.0 : last + 1;
+        } else if (first != -1) {
+            for (j = 0; j < n; j++) {
+                x[col_started(i, j)] = j >= first;
+                x[col_pending(i, j)] = j <= last;
+                x[col_on(i, j)] = j >= first && j <= last;
+            }
+        }
+    }
+}
+
+double *round_key;
+
+int compare_round_key(const void *a, const void *b) {
+    double ka = round_key[*(const int *) a], kb = round_key[*(const int *) b];
+    return (ka > kb) - (ka < kb);
+}
+
+/* orders the scenes by their expected day on the node LP and improves it with the local search */
+void round_node_solution(glp_tree *tree) {
+    glp_prob *lp = glp_ios_get_prob(tree);
+    int *order = malloc(sizeof(int) * n);
+    int j, d;
+    double cost;
+    for (j = 0; j < n; j++) {
+        order[j] = j;
+        round_key[j] = 0;
+        for (d = 0; d < n; d++)
+            round_key[j] += (d + 1) * glp_get_col_prim(lp, col_x(j, d));
+    }
+    qsort(order, n, sizeof(int), compare_round_key);
+    cost = local_search(order);
+    if (cost < heur_cost) {
+        memcpy(heur_order, order, sizeof(int) * n);
+        heur_cost = cost;
+        heur_pending = 1;
+    }
+    free(order);
+}
+
+/* scenes of actor i in cut_scenes, in increasing order, returns how many */
+int actor_scenes(int i) {
+    int w, k = 0;
+    unsigned long long bits;
+    for (w = 0; w < bit_words; w++)
+        for (bits = actor_bits[i * bit_words + w]; bits; bits &= bits - 1)
+            cut_scenes[k++] = w * 64 + __builtin_ctzll(bits);
+    return k;
+}
+
+int bits_subset(const unsigned long long *a, const unsigned long long *b) {
+    int w;
+    for (w = 0; w < bit_words; w++)
+        if (a[w] & ~b[w]) return 0;
+    return 1;
+}
+
+/* packs the actor-scene matrix into bit rows and finds the nested actor pairs */
+void build_actor_bits() {
+    int i, j, k;
+    bit_words = (n + 63) / 64;
+    actor_bits = calloc(m * bit_words, sizeof(unsigned long long));
+    for (i = 0; i < m; i++)
+        for (j = 0; j < n; j++)
+            if (T[i * n + j]) actor_bits[i * bit_words + j / 64] |= 1ULL << (j % 64);
+    nested = calloc(m * m, 1);
+    for (i = 0; i < m; i++)
+        for (k = 0; k < m; k++)
+            nested[i * m + k] = i != k && s[i] > 0 &&
+                                bits_subset(actor_bits + i * bit_words, actor_bits + k * bit_words);
+    cut_scenes = malloc(sizeof(int) * n);
+    cut_key = malloc(sizeof(double) * n);
+    cut_ind = malloc(sizeof(int) * (n * n + 2));
+    cut_val = malloc(sizeof(double) * (n * n + 2));
+}
+
+/* expected day of scene j on the LP solution */
+double lp_position(glp_prob *lp, int j) {
+    int d;
+    double position = 0;
+    for (d = 0; d < n; d++)
+        position += (d + 1) * glp_get_col_prim(lp, col_x(j, d));
+    return position;
+}
+
+/* adds the cut in cut_ind/cut_val to the cut pool, or straight to lp on the root mode (tree == NULL) */
+void add_cut(glp_tree *tree, glp_prob *lp, int len, int type, double rhs) {
+    int row;
+    if (tree != NULL) {
+        glp_ios_add_row(tree, NULL, CUT_CLASS, 0, len, cut_ind, cut_val, type, rhs);
+    } else {
+        row = add_row(lp, type, rhs);
+        glp_set_mat_row(lp, row, len, cut_ind, cut_val);
+    }
+    cut_count++;
+}
+
+/* FORM_POS: the q scenes of actor i with smallest (largest) LP day take q distinct days after its
+   first (before its last) day, so sum(p) - q * first >= q(q-1)/2 and q * last - sum(p) >= q(q-1)/2 */
+void separate_span_cuts(glp_tree *tree, glp_prob *lp) {
+    int i, j, k, q, d, len, size, best_q;
+    double sum, violation, best_violation, first, last, key;
+    for (i = 0; i < m && cut_count < CUT_MAX_PER_ROUND; i++) {
+        if (s[i] < 2) continue;
+        size = actor_scenes(i);
+        for (k = 0; k < size; k++)
+            cut_key[k] = lp_position(lp, cut_scenes[k]);
+        /* insertion sort by LP day, the scene sets are small */
+        for (k = 1; k < size; k++)
+            for (q = k; q > 0 && cut_key[q - 1] > cut_key[q]; q--) {
+                key = cut_key[q]; cut_key[q] = cut_key[q - 1]; cut_key[q - 1] = key;
+                j = cut_scenes[q]; cut_scenes[q] = cut_scenes[q - 1]; cut_scenes[q - 1] = j;
+            }
+        first = glp_get_col_prim(lp, col_first(i));
+        best_q = 0;
+        best_violation = CUT_EPS;
+        for (q = 1, sum = 0; q <= size; q++) {
+            sum += cut_key[q - 1];
+            violation = q * (q - 1) / 2.0 - (sum - q * first);
+            if (violation > best_violation) {
+                best_q = q;
+                best_violation = violation;
+            }
+        }
+        if (best_q) {
+            len = 0;
+            for (k = 0; k < best_q; k++)
+                for (d = 0; d < n; d++) {
+                    len++;
+                    cut_ind[len] = col_x(cut_scenes[k], d);
+                    cut_val[len] = d + 1;
+                }
+            len++;
+            cut_ind[len] = col_first(i);
+            cut_val[len] = -best_q;
+            add_cut(tree, lp, len, GLP_LO, best_q * (best_q - 1) / 2.0);
+        }
+        last = glp_get_col_prim(lp, col_last(i));
+        best_q = 0;
+        best_violation = CUT_EPS;
+        for (q = 1, sum = 0; q <= size; q++) {
+            sum += cut_key[size - q];
+            violation = q * (q - 1) / 2.0 - (q * last - sum);
+            if (violation > best_violation) {
+                best_q = q;
+                best_violation = violation;
+            }
+        }
+        if (best_q) {
+            len = 0;
+            for (k = size - best_q; k < size; k++)
+                for (d = 0; d < n; d++) {
+                    len++;
+                    cut_ind[len] = col_x(cut_scenes[k], d);
+                    cut_val[len] = -(d + 1);
+                }
+            len++;
+            cut_ind[len] = col_last(i);
+            cut_val[len] = best_q;
+            add_cut(tree, lp, len, GLP_LO, best_q * (best_q - 1) / 2.0);
+        }
+    }
+}
+
+/* FORM_POS: if the scenes of actor i are a subset of those of k, the interval of k contains the one
+   of i on every optimal solution (c[i] > 0 keeps first and last of i tight) */
+void separate_nesting_cuts(glp_tree *tree, glp_prob *lp) {
+    int i, k;
+    for (i = 0; i < m && cut_count < CUT_MAX_PER_ROUND; i++) {
+        if (c[i] <= 0) continue;
+        for (k = 0; k < m && cut_count < CUT_MAX_PER_ROUND; k++) {
+            if (!nested[i * m + k]) continue;
+            if (glp_get_col_prim(lp, col_first(k)) > glp_get_col_prim(lp, col_first(i)) + CUT_EPS) {
+                cut_ind[1] = col_first(i); cut_val[1] = 1.0;
+                cut_ind[2] = col_first(k); cut_val[2] = -1.0;
+                add_cut(tree, lp, 2, GLP_LO, 0.0);
+            }
+            if (glp_get_col_prim(lp, col_last(i)) > glp_get_col_prim(lp, col_last(k)) + CUT_EPS) {
+                cut_ind[1] = col_last(k); cut_val[1] = 1.0;
+                cut_ind[2] = col_last(i); cut_val[2] = -1.0;
+                add_cut(tree, lp, 2, GLP_LO, 0.0);
+            }
+        }
+    }
+}
+
+/* FORM_ON: actor i is started on day d if any of its scenes was shot until d, and still pending on
+   day d if any of its scenes is shot from d on */
+void separate_linking_cuts(glp_tree *tree, glp_prob *lp) {
+    int i, k, d, d2, len, size, best;
+    double shot, best_shot;
+    for (i = 0; i < m && cut_count < CUT_MAX_PER_ROUND; i++) {
+        if (s[i] == 0) continue;
+        size = actor_scenes(i);
+        /* cut_key[k] = fraction of scene k shot until the current day */
+        for (k = 0; k < size; k++)
+            cut_key[k] = 0;
+        for (d = 0; d < n && cut_count < CUT_MAX_PER_ROUND; d++) {
+            /* pending: g[i][d] + sum(x[j][d'], d' < d) >= 1, with the least shot scene */
+            best = 0;
+            for (k = 1; k < size; k++)
+                if (cut_key[k] < cut_key[best]) best = k;
+            if (glp_get_col_prim(lp, col_pending(i, d)) + cut_key[best] < 1.0 - CUT_EPS) {
+                len = 1;
+                cut_ind[1] = col_pending(i, d);
+                cut_val[1] = 1.0;
+                for (d2 = 0; d2 < d; d2++) {
+                    len++;
+                    cut_ind[len] = col_x(cut_scenes[best], d2);
+                    cut_val[len] = 1.0;
+                }
+                add_cut(tree, lp, len, GLP_LO, 1.0);
+            }
+            best = 0;
+            best_shot = -1;
+            for (k = 0; k < size; k++) {
+                shot = cut_key[k] + glp_get_col_prim(lp, col_x(cut_scenes[k], d));
+                cut_key[k] = shot;
+                if (shot > best_shot) {
+                    best = k;
+                    best_shot = shot;
+                }
+            }
+            /* started: e[i][d] - sum(x[j][d'], d' <= d) >= 0, with the most shot scene */
+            if (glp_get_col_prim(lp, col_started(i, d)) < best_shot - CUT_EPS) {
+                len = 1;
+                cut_ind[1] = col_started(i, d);
+                cut_val[1] = 1.0;
+                for (d2 = 0; d2 <= d; d2++) {
+                    len++;
+                    cut_ind[len] = col_x(cut_scenes[best], d2);
+                    cut_val[len] = -1.0;
+                }
+                add_cut(tree, lp, len, GLP_LO, 0.0);
+            }
+        }
+    }
+}
+
+/* separates the cuts of the current formulation, at most CUT_MAX_ROUNDS rounds per node */
+void generate_cuts(glp_tree *tree) {
+    glp_prob *lp = glp_ios_get_prob(tree);
+    if (glp_ios_curr_node(tree) != cut_node) {
+        cut_node = glp_ios_curr_node(tree);
+        cut_rounds = 0;
+    }
+    if (cut_rounds++ >= CUT_MAX_ROUNDS) return;
+    cut_count = 0;
+    if (formulation == FORM_POS) {
+        separate_span_cuts(tree, lp);
+        separate_nesting_cuts(tree, lp);
+    } else {
+        separate_linking_cuts(tree, lp);
+    }
+}
+
+/* takes a better incumbent found by another engine as the heuristic solution */
+void read_channel() {
+    int scenes_num;
+    channel_read(channel, channel_order, &scenes_num, NULL);
+    if (scenes_num != n) return;
+    memcpy(heur_order, channel_order, sizeof(int) * n);
+    heur_cost = order_cost(heur_order);
+    heur_pending = 1;
+}
+
+/* publishes the new integer solution found by GLPK */
+void publish_node_solution(glp_tree *tree) {
+    glp_prob *lp = glp_ios_get_prob(tree);
+    int j, d;
+    for (j = 0; j < n; j++)
+        for (d = 0; d < n; d++)
+            if (glp_get_col_prim(lp, col_x(j, d)) > 0.5)
+                channel_order[d] = j;
+    channel_publish(channel, (unsigned long) (order_cost(channel_order) + 0.5), channel_order, n, "pli");
+}
+
 void cb_func(glp_tree *T, void *info) {
     double aux;
     int bn;
 
+    if (glp_ios_reason(T) == GLP_IHEUR && heur_order != NULL) {
+        if (++heur_calls % HEUR_ROUND_FREQ == 0)
+            round_node_solution(T);
+        if (channel != NULL && channel_cost(channel) < heur_cost)
+            read_channel();
+        if (heur_pending) {
+            if (channel != NULL)
+                channel_publish(channel, (unsigned long) heur_cost, heur_order, n, "pli");
+            fill_solution(heur_order, heur_x);
+            glp_ios_heur_sol(T, heur_x);
+            heur_pending = 0;
+        }
+    }
+
+    if (glp_ios_reason(T) == GLP_IBINGO && channel != NULL)
+        publish_node_solution(T);
+
+    if (glp_ios_reason(T) == GLP_ICUTGEN && actor_bits != NULL)
+        generate_cuts(T);
+
     glp_ios_tree_size(T, &a_cnt, &n_cnt, &t_cnt);
     bn=glp_ios_best_node(T);
     aux=glp_ios_node_bound(T,bn);
@@ -33,11 +578,251 @@ void cb_func(glp_tree *T, void *info) {
     return;
 }
 
+/* builds the talent scheduling MIP with the chosen formulation, the objective is the waiting cost */
+void build_model(glp_prob *mip) {
+    int i, j, d, row;
+    double constant = 0;
+
+    glp_set_prob_name(mip, "talent");
+    glp_set_obj_dir(mip, GLP_MIN);
+    if (formulation == FORM_POS)
+        glp_add_cols(mip, n * n + 2 * m);
+    else
+        glp_add_cols(mip, n * n + 3 * m * n);
+    for (j = 0; j < n; j++)
+        for (d = 0; d < n; d++)
+            glp_set_col_kind(mip, col_x(j, d), GLP_BV);
+
+    /* each scene on one day and one scene per day */
+    for (j = 0; j < n; j++) {
+        row = add_row(mip, GLP_FX, 1.0);
+        for (d = 0; d < n; d++)
+            add_nz(row, col_x(j, d), 1.0);
+    }
+    for (d = 0; d < n; d++) {
+        row = add_row(mip, GLP_FX, 1.0);
+        for (j = 0; j < n; j++)
+            add_nz(row, col_x(j, d), 1.0);
+    }
+
+    for (i = 0; i < m; i++) {
+        if (formulation == FORM_POS) {
+            glp_set_col_bnds(mip, col_first(i), GLP_DB, 1.0, n);
+            glp_set_col_bnds(mip, col_last(i), GLP_DB, 1.0, n);
+            if (s[i] == 0) continue;
+            /* waiting days = last - first + 1 - s */
+            glp_set_obj_coef(mip, col_first(i), -c[i]);
+            glp_set_obj_coef(mip, col_last(i), c[i]);
+            constant += c[i] * (1 - s[i]);
+            for (j = 0; j < n; j++) {
+                if (!T[i * n + j]) continue;
+                row = add_row(mip, GLP_UP, 0.0);
+                add_nz(row, col_first(i), 1.0);
+                for (d = 0; d < n; d++)
+                    add_nz(row, col_x(j, d), -(d + 1));
+                row = add_row(mip, GLP_LO, 0.0);
+                add_nz(row, col_last(i), 1.0);
+                for (d = 0; d < n; d++)
+                    add_nz(row, col_x(j, d), -(d + 1));
+            }
+            row = add_row(mip, GLP_LO, s[i] - 1);
+            add_nz(row, col_last(i), 1.0);
+            add_nz(row, col_first(i), -1.0);
+        } else {
+            for (d = 0; d < n; d++) {
+                glp_set_col_bnds(mip, col_started(i, d), GLP_DB, 0.0, 1.0);
+                glp_set_col_bnds(mip, col_pending(i, d), GLP_DB, 0.0, 1.0);
+                glp_set_col_bnds(mip, col_on(i, d), GLP_DB, 0.0, 1.0);
+            }
+            if (s[i] == 0) continue;
+            /* waiting days = days on location - s */
+            constant -= c[i] * s[i];
+            for (d = 0; d < n; d++) {
+                glp_set_obj_coef(mip, col_on(i, d), c[i]);
+                /* started and pending on the days of its scenes */
+                row = add_row(mip, GLP_LO, 0.0);
+                add_nz(row, col_started(i, d), 1.0);
+                for (j = 0; j < n; j++)
+                    if (T[i * n + j]) add_nz(row, col_x(j, d), -1.0);
+                row = add_row(mip, GLP_LO, 0.0);
+                add_nz(row, col_pending(i, d), 1.0);
+                for (j = 0; j < n; j++)
+                    if (T[i * n + j]) add_nz(row, col_x(j, d), -1.0);
+                /* started never decreases, pending never increases */
+                if (d > 0) {
+                    row = add_row(mip, GLP_LO, 0.0);
+                    add_nz(row, col_started(i, d), 1.0);
+                    add_nz(row, col_started(i, d - 1), -1.0);
+                    row = add_row(mip, GLP_LO, 0.0);
+                    add_nz(row, col_pending(i, d - 1), 1.0);
+                    add_nz(row, col_pending(i, d), -1.0);
+                }
+                /* on location between its first and last scenes */
+                row = add_row(mip, GLP_LO, -1.0);
+                add_nz(row, col_on(i, d), 1.0);
+                add_nz(row, col_started(i, d), -1.0);
+                add_nz(row, col_pending(i, d), -1.0);
+            }
+        }
+    }
+    glp_set_obj_coef(mip, 0, constant);
+    glp_load_matrix(mip, ne, ia, ja, ar);
+}
+
+/* root mode: solves the LP relaxation with a few cut rounds and writes to root_path the bound,
+   the LP day of each scene and the reduced cost of each x[j][d] at its lower bound, one scene per line */
+void solve_root(glp_prob *mip, const char *root_path) {
+    FILE *f;
+    int j, d, round;
+    double bound;
+    glp_simplex(mip, NULL);
+    for (round = 0; round < ROOT_CUT_ROUNDS && glp_get_status(mip) == GLP_OPT; round++) {
+        cut_count = 0;
+        if (formulation == FORM_POS) {
+            separate_span_cuts(NULL, mip);
+            separate_nesting_cuts(NULL, mip);
+        } else {
+            separate_linking_cuts(NULL, mip);
+        }
+        if (cut_count == 0) break;
+        glp_simplex(mip, NULL);
+    }
+    if (glp_get_status(mip) != GLP_OPT) {
+        fprintf(stderr, "Error on solving the LP relaxation\n");
+        return;
+    }
+    bound = glp_get_obj_val(mip);
+    bestDB = bound;
+    f = fopen(root_path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Error on writing %s\n", root_path);
+        return;
+    }
+    /* full precision, bnb sums up to n reduced costs to prune */
+    fprintf(f, "%.17g\n%d\n", bound, n);
+    for (j = 0; j < n; j++)
+        fprintf(f, "%.17g ", lp_position(mip, j));
+    fprintf(f, "\n");
+    for (j = 0; j < n; j++) {
+        for (d = 0; d < n; d++)
+            fprintf(f, "%.17g ", glp_get_col_stat(mip, col_x(j, d)) == GLP_NL ?
+                                 glp_get_col_dual(mip, col_x(j, d)) : 0.0);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    printf("root bound %.2lf after %d cut rounds\n", bound, round);
+}
+
+/* solves the .txt instance with the model built directly through the API, or only its root if
+   root_path is given */
+int solve_native(const char *path, const char *root_path) {
+    glp_iocp iocp;
+    glp_prob *mip;
+    clock_t start;
+    double build_time, solve_time;
+    int j, d, status;
+
+    if (read_instance(path) != 0) {
+        fprintf(stderr, "Error on reading instance\n");
+        return 1;
+    }
+    start = clock();
+    mip = glp_create_prob();
+    build_model(mip);
+    build_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    /* initial incumbent, injected on the first heuristic call */
+    heur_cols = glp_get_num_cols(mip);
+    heur_order = malloc(sizeof(int) * n);
+    heur_x = malloc(sizeof(double) * (heur_cols + 1));
+    round_key = malloc(sizeof(double) * n);
+    channel_order = malloc(sizeof(int) * CHANNEL_MAX_SCENES);
+    greedy_order(heur_order);
+    heur_cost = local_search(heur_order);
+    heur_pending = 1;
+    build_actor_bits();
+    if (root_path != NULL) {
+        solve_root(mip, root_path);
+        goto done;
+    }
+    glp_simplex(mip, NULL);
+    glp_init_iocp(&iocp);
+    iocp.cb_func = cb_func;
+    iocp.tm_lim = TLIM_PLI;  /* limite de tempo de execução (em ms) */
+    iocp.bt_tech = GLP_BT_BPH;
+    glp_intopt(mip, &iocp);
+    solve_time = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    status = glp_mip_status(mip);
+    if (status == GLP_OPT || status == GLP_FEAS) {
+        /* day of each scene */
+        for (j = 0; j < n; j++)
+            for (d = 0; d < n; d++)
+                if (glp_mip_col_val(mip, col_x(j, d)) > 0.5)
+                    printf("%d ", d + 1);
+        printf("\n%.0lf\n", glp_mip_obj_val(mip));
+    } else {
+        printf("\n-1\n");
+    }
+    if (status == GLP_OPT)
+        bestDB = glp_mip_obj_val(mip);
+    if (channel != NULL && bestDB > 0)
+        channel_publish_bound(channel, (unsigned long) ceil(bestDB - 1e-6));
+    printf("build %.3lf s, solve %.3lf s, %d rows, %d cols, %d nz, heuristic %.0lf\n", build_time, solve_time,
+           glp_get_num_rows(mip), glp_get_num_cols(mip), ne, heur_cost);
+    printf("%.2lf\n", bestDB);
+    printf("%d\n", t_cnt);
+
+ done:
+    glp_delete_prob(mip);
+    free(ia);
+    free(ja);
+    free(ar);
+    free(heur_order);
+    free(heur_x);
+    free(round_key);
+    free(channel_order);
+    free(actor_bits);
+    free(nested);
+    free(cut_scenes);
+    free(cut_key);
+    free(cut_ind);
+    free(cut_val);
+    free(T);
+    free(c);
+    free(s);
+    return 0;
+}
+
+/* pli-solver <instance.dat | instance.txt> [pos | on] [--root <file>] [--shared <shm name>]
+   .dat instances go through pli.mod, .txt instances are built directly with the chosen formulation,
+   --root only solves their root LP and writes the bound and reduced costs to file, --shared
+   exchanges incumbents with the other engines of a portfolio run */
 int main(int argc, char* argv[]) {
     glp_iocp iocp;
     glp_prob *mip;
     glp_tran *tran;
-    int ret;
+    const char *root_path = NULL;
+    int ret, i;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <instance.dat | instance.txt | instance.bin> [pos | on] [--root <file>] [--shared <shm name>]\n",
+                argv[0]);
+        return 1;
+    }
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "on") == 0)
+            formulation = FORM_ON;
+        else if (strcmp(argv[i], "pos") == 0)
+            formulation = FORM_POS;
+        else if (strcmp(argv[i], "--root") == 0 && i + 1 < argc)
+            root_path = argv[++i];
+        else if (strcmp(argv[i], "--shared") == 0 && i + 1 < argc)
+            channel = channel_open(argv[++i], 0);
+    }
+    if (strlen(argv[1]) < 4 || strcmp(argv[1] + strlen(argv[1]) - 4, ".dat") != 0)
+        return solve_native(argv[1], root_path);
 
     /* glp_term_out(GLP_OFF); */
     mip = glp_create_prob();
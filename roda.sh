@@ -77,7 +77,11 @@ cd "$dir_codigo"
 # Compila programa
 if [ "$alg" != "pli" ]
 then
-    if [ -f "Makefile" ]
+    if [ -f "CMakeLists.txt" ]
+    then
+        # Compila com CMake (Release) e copia o executavel para o diretorio de codigo
+        mkdir -p build && (cd build && cmake -DCMAKE_BUILD_TYPE=Release .. > /dev/null && make "$alg") && cp "build/$alg" .
+    elif [ -f "Makefile" ]
     then
         # Compila com Makefile
         make
@@ -181,4 +185,4 @@ then
 fi
 
 # Apaga arquivos compilados
-rm -f *.o bnb heur
+rm -rf *.o bnb heur build